@@ -0,0 +1,26 @@
+// Copyright 2024 James Chen
+
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+void* operator new(const std::size_t size) {
+    FP::countAllocation();
+    while (true) {
+        if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+            return pointer;
+        }
+
+        // Like the default operator, let the new handler free memory before giving up
+        const auto newHandler = std::get_new_handler();
+        if (newHandler == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        newHandler();
+    }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
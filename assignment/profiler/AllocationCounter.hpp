@@ -0,0 +1,25 @@
+// Copyright 2024 James Chen
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstdint>
+
+namespace FP {
+
+/**
+ * @brief Counts an allocation made by the global operator new. The counting operator is replaced in
+ * AllocationCounter.cpp, which only the tests, the benchmarks and the profiling builds link, so the
+ * other programs do not pay for the count.
+ */
+void countAllocation();
+
+/**
+ * @brief Returns the number of allocations counted since the program started; always 0 in a program
+ * that does not link AllocationCounter.cpp.
+ */
+[[nodiscard]] uint64_t allocationCount();
+
+}  // namespace FP
+
+#endif
@@ -0,0 +1,144 @@
+// Copyright 2024 James Chen
+
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "AllocationCounter.hpp"
+
+namespace {
+
+/**
+ * @brief The number of draw calls counted since the program started.
+ */
+std::atomic<uint64_t> draw_call_count{ 0 };
+
+/**
+ * @brief The number of allocations counted by the replaced global operator new.
+ */
+std::atomic<uint64_t> allocation_count{ 0 };
+
+/**
+ * @brief Returns the value at a percentile of some values by the nearest-rank method; the values
+ * are reordered.
+ */
+double nearest_rank(std::vector<double>& values, const double percentile) {
+    const auto rank = static_cast<std::size_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+    const auto index = std::clamp<std::size_t>(rank, 1, values.size()) - 1;
+    const auto nth = values.begin() + static_cast<std::ptrdiff_t>(index);
+    std::nth_element(values.begin(), nth, values.end());
+
+    return values[index];
+}
+
+}  // namespace
+
+namespace FP {
+
+void countDrawCall() { draw_call_count.fetch_add(1, std::memory_order_relaxed); }
+
+void countAllocation() { allocation_count.fetch_add(1, std::memory_order_relaxed); }
+
+uint64_t allocationCount() { return allocation_count.load(std::memory_order_relaxed); }
+
+FrameProfiler::FrameProfiler(const std::size_t windowSize) {
+    if (windowSize == 0) {
+        throw std::invalid_argument("The window size of the profiler must be positive.");
+    }
+
+    m_frames.resize(windowSize);
+    m_scratch.reserve(windowSize);
+}
+
+void FrameProfiler::beginFrame() {
+    m_frameStartTime = Clock::now();
+    m_currentFrame = FrameRecord{};
+    m_currentFrame.index = m_frameCount;
+    m_frameStartDrawCalls = draw_call_count.load(std::memory_order_relaxed);
+    m_frameStartAllocations = allocationCount();
+}
+
+void FrameProfiler::beginSection(const Section section) {
+    m_sectionStartTimes[static_cast<int>(section)] = Clock::now();
+}
+
+void FrameProfiler::endSection(const Section section) {
+    const auto milliseconds =
+        millisecondsBetween(m_sectionStartTimes[static_cast<int>(section)], Clock::now());
+    if (section == Section::Update) {
+        m_currentFrame.updateMilliseconds += milliseconds;
+    } else {
+        m_currentFrame.drawMilliseconds += milliseconds;
+    }
+}
+
+void FrameProfiler::endFrame() {
+    m_currentFrame.frameMilliseconds = millisecondsBetween(m_frameStartTime, Clock::now());
+    m_currentFrame.drawCalls =
+        draw_call_count.load(std::memory_order_relaxed) - m_frameStartDrawCalls;
+    m_currentFrame.allocations = allocationCount() - m_frameStartAllocations;
+    m_frames[m_frameCount % m_frames.size()] = m_currentFrame;
+    ++m_frameCount;
+
+    if (m_trace.is_open()) {
+        const auto& frame = m_currentFrame;
+        m_trace << frame.index << ',' << frame.frameMilliseconds << ','
+                << frame.updateMilliseconds << ',' << frame.drawMilliseconds << ','
+                << frame.drawCalls << ',' << frame.allocations << '\n';
+    }
+}
+
+uint64_t FrameProfiler::frameCount() const { return m_frameCount; }
+
+const FrameRecord& FrameProfiler::lastFrame() const {
+    return m_frames[(m_frameCount + m_frames.size() - 1) % m_frames.size()];
+}
+
+Percentiles FrameProfiler::percentiles(const Metric metric) const {
+    const auto count = static_cast<std::size_t>(
+        std::min<uint64_t>(m_frameCount, static_cast<uint64_t>(m_frames.size())));
+    if (count == 0) {
+        return {};
+    }
+
+    m_scratch.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& frame = m_frames[i];
+        m_scratch.push_back(metric == Metric::Frame    ? frame.frameMilliseconds
+                            : metric == Metric::Update ? frame.updateMilliseconds
+                                                       : frame.drawMilliseconds);
+    }
+
+    Percentiles percentiles;
+    percentiles.max = *std::max_element(m_scratch.begin(), m_scratch.end());
+    percentiles.p99 = nearest_rank(m_scratch, 99.0);
+    percentiles.p95 = nearest_rank(m_scratch, 95.0);
+    percentiles.p50 = nearest_rank(m_scratch, 50.0);
+
+    return percentiles;
+}
+
+void FrameProfiler::startTrace(const std::string& filename) {
+    m_trace.close();
+    m_trace.open(filename);
+    if (!m_trace.is_open()) {
+        throw std::invalid_argument("Failed to open the trace file: " + filename);
+    }
+
+    m_trace << "frame,frame_ms,update_ms,draw_ms,draw_calls,allocations\n";
+}
+
+void FrameProfiler::stopTrace() { m_trace.close(); }
+
+bool FrameProfiler::isTracing() const { return m_trace.is_open(); }
+
+double FrameProfiler::millisecondsBetween(
+    const Clock::time_point from, const Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+}  // namespace FP
@@ -0,0 +1,190 @@
+// Copyright 2024 James Chen
+
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Frame profiler namespace: the instrumentation shared by the games.
+ */
+namespace FP {
+
+/**
+ * @brief Enumerates the timed sections of a frame.
+ */
+enum class Section { Update, Draw };
+
+/**
+ * @brief Enumerates the times of a frame that percentiles can be computed for.
+ */
+enum class Metric { Frame, Update, Draw };
+
+/**
+ * @brief The measurements of a frame. The frame time is the time from the beginning to the end of
+ * the frame; when the frame ends after the display, it includes the time spent waiting for the
+ * frame rate limit.
+ */
+struct FrameRecord {
+    uint64_t index = 0;
+    double frameMilliseconds = 0.0;
+    double updateMilliseconds = 0.0;
+    double drawMilliseconds = 0.0;
+    uint64_t drawCalls = 0;
+    uint64_t allocations = 0;
+};
+
+/**
+ * @brief The percentiles of a time over the recent frames, in milliseconds.
+ */
+struct Percentiles {
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief Counts a draw call on a render target. The drawables call it next to each draw call of a
+ * vertex array, a sprite or a text, since SFML does not count them.
+ */
+void countDrawCall();
+
+/**
+ * @brief This class measures the frames of a game loop: the frame, update and draw times, the draw
+ * calls and the allocations of each frame. The recent frames are kept in a ring buffer for rolling
+ * percentiles, and every frame can be written to a CSV trace to find stutters afterwards. Recording
+ * a frame does not allocate. The allocations are only counted in a program that links
+ * AllocationCounter.cpp.
+ */
+class FrameProfiler {
+ public:
+    /**
+     * @brief The default number of recent frames for the percentiles; 4 seconds at 60 frames per
+     * second.
+     */
+    static constexpr std::size_t DEFAULT_WINDOW_SIZE = 240;
+
+    /**
+     * @brief Creates a frame profiler.
+     * @param windowSize The number of recent frames for the percentiles.
+     * @throws std::invalid_argument if the window size is 0.
+     */
+    explicit FrameProfiler(std::size_t windowSize = DEFAULT_WINDOW_SIZE);
+
+    /**
+     * @brief Begins a frame; it should be called at the beginning of each iteration of the loop.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Begins a timed section of the current frame.
+     */
+    void beginSection(Section section);
+
+    /**
+     * @brief Ends a timed section of the current frame; the time is added to the section.
+     */
+    void endSection(Section section);
+
+    /**
+     * @brief Ends the current frame: records it, and writes it to the trace if one is open. It
+     * should be called after the window is displayed.
+     */
+    void endFrame();
+
+    /**
+     * @brief Returns the number of frames recorded.
+     */
+    [[nodiscard]] uint64_t frameCount() const;
+
+    /**
+     * @brief Returns the last recorded frame.
+     */
+    [[nodiscard]] const FrameRecord& lastFrame() const;
+
+    /**
+     * @brief Returns the percentiles of a time over the recent frames; all zeros before the first
+     * frame is recorded.
+     */
+    [[nodiscard]] Percentiles percentiles(Metric metric) const;
+
+    /**
+     * @brief Starts writing every frame to a CSV trace file, with a header line.
+     * @param filename The filename of the trace file.
+     * @throws std::invalid_argument if the file cannot be opened.
+     */
+    void startTrace(const std::string& filename);
+
+    /**
+     * @brief Stops writing the trace and closes the file.
+     */
+    void stopTrace();
+
+    /**
+     * @brief Returns whether a trace is being written.
+     */
+    [[nodiscard]] bool isTracing() const;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Returns the milliseconds between two time points.
+     */
+    [[nodiscard]] static double millisecondsBetween(Clock::time_point from, Clock::time_point to);
+
+    /**
+     * @brief The recent frames; m_frameCount % size is the position of the next frame.
+     */
+    std::vector<FrameRecord> m_frames;
+
+    /**
+     * @brief The number of frames recorded.
+     */
+    uint64_t m_frameCount = 0;
+
+    /**
+     * @brief The frame being measured.
+     */
+    FrameRecord m_currentFrame;
+
+    /**
+     * @brief The time when the current frame began.
+     */
+    Clock::time_point m_frameStartTime;
+
+    /**
+     * @brief The times when the update and draw sections began.
+     */
+    std::array<Clock::time_point, 2> m_sectionStartTimes;
+
+    /**
+     * @brief The number of draw calls counted when the current frame began.
+     */
+    uint64_t m_frameStartDrawCalls = 0;
+
+    /**
+     * @brief The number of allocations made when the current frame began.
+     */
+    uint64_t m_frameStartAllocations = 0;
+
+    /**
+     * @brief The scratch buffer for the percentiles, reserved to the window size.
+     */
+    mutable std::vector<double> m_scratch;
+
+    /**
+     * @brief The CSV trace file.
+     */
+    std::ofstream m_trace;
+};
+
+}  // namespace FP
+
+#endif
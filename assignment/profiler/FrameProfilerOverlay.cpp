@@ -0,0 +1,77 @@
+// Copyright 2024 James Chen
+
+#include "FrameProfilerOverlay.hpp"
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Writes a line of the percentiles of a time.
+ */
+void write_percentiles(
+    std::ostringstream& stream, const std::string& name, const FP::Percentiles& percentiles) {
+    stream << std::setw(6) << std::left << name << std::right << " p50 " << std::setw(5)
+           << percentiles.p50 << "  p95 " << std::setw(5) << percentiles.p95 << "  p99 "
+           << std::setw(5) << percentiles.p99 << "  max " << std::setw(5) << percentiles.max
+           << " ms\n";
+}
+
+}  // namespace
+
+namespace FP {
+
+FrameProfilerOverlay::FrameProfilerOverlay(
+    const FrameProfiler& profiler, const std::string& fontFilename) : m_profiler(profiler) {
+    m_font.loadFromFile(fontFilename);
+    m_text.setFont(m_font);
+    m_text.setCharacterSize(FONT_SIZE);
+    m_text.setFillColor(sf::Color::White);
+    m_background.setFillColor(sf::Color(0, 0, 0, 160));
+}
+
+bool FrameProfilerOverlay::isVisible() const { return m_isVisible; }
+
+void FrameProfilerOverlay::setVisible(const bool isVisible) { m_isVisible = isVisible; }
+
+void FrameProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!m_isVisible) {
+        return;
+    }
+
+    const auto frameCount = m_profiler.frameCount();
+    if (!m_isRefreshed || frameCount >= m_refreshedFrameCount + REFRESH_INTERVAL_IN_FRAMES) {
+        refresh();
+    }
+
+    // Keep the overlay in the upper-right corner of the window whatever the camera shows
+    const auto view = target.getView();
+    target.setView(target.getDefaultView());
+    const auto backgroundSize = m_background.getSize();
+    const sf::Vector2f position{ static_cast<float>(target.getSize().x) - backgroundSize.x, 0.0F };
+    m_background.setPosition(position);
+    m_text.setPosition(position.x + PADDING, position.y + PADDING);
+    target.draw(m_background, states);
+    target.draw(m_text, states);
+    target.setView(view);
+}
+
+void FrameProfilerOverlay::refresh() const {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1);
+    write_percentiles(stream, "frame", m_profiler.percentiles(Metric::Frame));
+    write_percentiles(stream, "update", m_profiler.percentiles(Metric::Update));
+    write_percentiles(stream, "draw", m_profiler.percentiles(Metric::Draw));
+    const auto& lastFrame = m_profiler.lastFrame();
+    stream << "draw calls " << lastFrame.drawCalls << "  allocations " << lastFrame.allocations;
+    m_text.setString(stream.str());
+
+    const auto bounds = m_text.getLocalBounds();
+    m_background.setSize({ bounds.left + bounds.width + PADDING * 2.0F,
+                           bounds.top + bounds.height + PADDING * 2.0F });
+    m_refreshedFrameCount = m_profiler.frameCount();
+    m_isRefreshed = true;
+}
+
+}  // namespace FP
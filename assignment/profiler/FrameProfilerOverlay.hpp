@@ -0,0 +1,104 @@
+// Copyright 2024 James Chen
+
+#ifndef FRAMEPROFILEROVERLAY_HPP
+#define FRAMEPROFILEROVERLAY_HPP
+
+#include <cstdint>
+#include <string>
+#include <SFML/Graphics.hpp>
+#include "FrameProfiler.hpp"
+
+namespace FP {
+
+/**
+ * @brief This class draws the measurements of a frame profiler over a game in the upper-right
+ * corner of the target: the percentiles of the frame, update and draw times over the recent frames,
+ * and the draw calls and allocations of the last frame. The text is rebuilt every few frames only,
+ * so the overlay barely affects what it measures.
+ */
+class FrameProfilerOverlay : public sf::Drawable {
+ public:
+    /**
+     * @brief The number of frames between two rebuilds of the text.
+     */
+    static constexpr uint64_t REFRESH_INTERVAL_IN_FRAMES = 15;
+
+    /**
+     * @brief Creates an overlay of a profiler. The overlay is hidden at first.
+     * @param profiler The profiler to show; it must outlive the overlay.
+     * @param fontFilename The filename of the font of the text.
+     */
+    FrameProfilerOverlay(const FrameProfiler& profiler, const std::string& fontFilename);
+
+    /**
+     * @brief Returns whether the overlay is visible.
+     */
+    [[nodiscard]] bool isVisible() const;
+
+    /**
+     * @brief Shows or hides the overlay.
+     */
+    void setVisible(bool isVisible);
+
+ protected:
+    /**
+     * @brief Draws the overlay in the default view of the target, so that it does not move with
+     * the camera; the view of the target is restored afterwards.
+     */
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+ private:
+    /**
+     * @brief The font size of the text.
+     */
+    static constexpr unsigned FONT_SIZE = 16;
+
+    /**
+     * @brief The space between the text and the edges of the background in pixels.
+     */
+    static constexpr float PADDING = 8.0F;
+
+    /**
+     * @brief Rebuilds the text from the profiler, and resizes the background to fit it.
+     */
+    void refresh() const;
+
+    /**
+     * @brief The profiler to show.
+     */
+    const FrameProfiler& m_profiler;
+
+    /**
+     * @brief Whether the overlay is visible.
+     */
+    bool m_isVisible = false;
+
+    /**
+     * @brief The font of the text.
+     */
+    sf::Font m_font;
+
+    /**
+     * @brief The text of the measurements.
+     */
+    mutable sf::Text m_text;
+
+    /**
+     * @brief The translucent background behind the text.
+     */
+    mutable sf::RectangleShape m_background;
+
+    /**
+     * @brief The frame count of the profiler when the text was last rebuilt.
+     */
+    mutable uint64_t m_refreshedFrameCount = 0;
+
+    /**
+     * @brief Whether the text has been built.
+     */
+    mutable bool m_isRefreshed = false;
+};
+
+}  // namespace FP
+
+#endif
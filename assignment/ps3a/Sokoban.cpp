@@ -4,82 +4,59 @@
 #include <iostream>
 #include <string>
 #include <unordered_map>
-#include <vector>
+#include <unordered_set>
 
 namespace SB {
 
-Sokoban::Sokoban() :
-    m_width(0), m_height(0), m_playerLoc({ 0, 0 }), player(nullptr), timeElapsedInMs(0) {
+Sokoban::Sokoban() {
     initTileMap();
     initPlayerTextureMap();
 
-    // The player orientates downward at the beginning
-    setPlayerOrientation(Direction::Down);
-
     // Initailizes font
     m_font.loadFromFile("assets/font/digital-7.mono.ttf");
 }
 
 Sokoban::~Sokoban() {
-    // Delete tiles in tiles vector
-    for (const auto& tile : tiles) {
-        delete tile;
+    // Delete tile textures; some tile characters share a texture
+    std::unordered_set<sf::Texture*> tileTextures;
+    for (auto& [tileChar, tileTexture] : tileMap) {
+        tileTextures.insert(tileTexture);
+    }
+    for (auto* const tileTexture : tileTextures) {
+        delete tileTexture;
     }
-    tiles.clear();
+    tileMap.clear();
 
     // Delete player textures
     for (auto& [name, playerTexture] : playerTextureMap) {
         delete playerTexture;
     }
     playerTextureMap.clear();
-
-    // Delete player sprite
-    delete player;
-}
-
-int Sokoban::width() const { return m_width; }
-
-int Sokoban::height() const { return m_height; }
-
-sf::Vector2i Sokoban::playerLoc() const { return m_playerLoc; }
-
-// ReSharper disable once CppMemberFunctionMayBeStatic
-void Sokoban::movePlayer(const Direction& direction) {}
-
-// ReSharper disable once CppMemberFunctionMayBeStatic
-bool Sokoban::isWon() { return false; }
-
-void Sokoban::update(const int& dt) { timeElapsedInMs += dt; }
-
-sf::Sprite* Sokoban::getTile(const sf::Vector2i& coordinate) const {
-    const int index = coordinate.x + coordinate.y * m_width;
-    return tiles.at(index);
 }
 
 void Sokoban::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    // Draw tiles
-    for (int row = 0; row < m_height; ++row) {
-        for (int col = 0; col < m_width; ++col) {
-            auto* const tile = getTile({ col, row });
-            if (tile == nullptr) {
-                continue;
-            }
-
-            auto position = sf::Vector2f{ static_cast<float>(col * TILE_WIDTH),
-                                          static_cast<float>(row * TILE_HEIGHT) };
-            tile->setPosition(position);
-            target.draw(*tile);
-        }
-    }
+    // Draw tiles; the tile characters come from the game engine
+    sf::Sprite tile;
+    traverseTileCharGrid([&](const sf::Vector2i& coordinate, const TileChar tileChar) {
+        tile.setTexture(*tileMap.at(tileChar));
+        tile.setPosition({ static_cast<float>(coordinate.x * TILE_WIDTH),
+                           static_cast<float>(coordinate.y * TILE_HEIGHT) });
+        target.draw(tile);
+
+        return false;
+    });
 
     // Draw the player
-    player->setPosition({
-        static_cast<float>(m_playerLoc.x * TILE_WIDTH),
-        static_cast<float>(m_playerLoc.y * TILE_HEIGHT),
+    const auto playerLoc = this->playerLoc();
+    sf::Sprite player{ *playerTextureMap.at(playerOrientation()) };
+    player.setPosition({
+        static_cast<float>(playerLoc.x * TILE_WIDTH),
+        static_cast<float>(playerLoc.y * TILE_HEIGHT),
     });
-    target.draw(*player);
+    target.draw(player);
 
     // Draw the elapsed time for extra credit
+    const auto timeElapsedInMs = static_cast<unsigned>(elapsedTime() / 1000);
     const unsigned seconds = timeElapsedInMs / 1000U;
     const unsigned minutes = seconds / 60U;
     const unsigned hours = minutes / 60U;
@@ -100,41 +77,6 @@ void Sokoban::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     target.draw(text);
 }
 
-std::ifstream& operator>>(std::ifstream& ifstream, Sokoban& sokoban) {
-    // Clear all tiles
-    for (auto& tile : sokoban.tiles) {
-        delete tile;
-        tile = nullptr;
-    }
-    sokoban.tiles.clear();
-
-    // The first line consists of height and width
-    ifstream >> sokoban.m_height >> sokoban.m_width;
-
-    // Continue the read the following lines
-    std::string line;
-    getline(ifstream, line);
-    for (int row = 0; row < sokoban.m_height; ++row) {
-        getline(ifstream, line);
-        for (int col = 0; col < sokoban.m_width; ++col) {
-            const char c = line.at(col);
-            auto* const tile = sokoban.charToTile(c);
-            if (tile == nullptr) {
-                continue;
-            }
-
-            sokoban.tiles.push_back(tile);
-            if (c == TILE_CHAR_PLYAER) {
-                sokoban.m_playerLoc = { col, row };
-            }
-        }
-    }
-
-    return ifstream;
-}
-
-std::ofstream& operator<<(std::ofstream& ofstream, const Sokoban& sokoban) { return ofstream; }
-
 void loadLevel(Sokoban& sokoban, const std::string& levelFilename) {
     std::ifstream ifstream{ levelFilename };
     if (!ifstream.is_open()) {
@@ -144,19 +86,6 @@ void loadLevel(Sokoban& sokoban, const std::string& levelFilename) {
     ifstream >> sokoban;
 }
 
-sf::Sprite* Sokoban::charToTile(const char& c) const {
-    const auto it = tileMap.find(c);
-    if (it == tileMap.end()) {
-        return nullptr;
-    }
-
-    const auto* const texture{ it->second };
-    auto* const sprite{ new sf::Sprite };
-    sprite->setTexture(*texture);
-
-    return sprite;
-}
-
 void Sokoban::initTileMap() {
     auto* const groundTexture{ new sf::Texture };
     auto* const groundStorageTexture{ new sf::Texture };
@@ -168,12 +97,13 @@ void Sokoban::initTileMap() {
     crateTexture->loadFromFile(TILE_CRATE_03_FILENAME);
     wallTexture->loadFromFile(TILE_BLOCK_06_FILENAME);
 
-    tileMap[TILE_CHAR_PLYAER] = groundTexture;
-    tileMap[TILE_CHAR_EMPTY] = groundTexture;
-    tileMap[TILE_CHAR_WALL] = wallTexture;
-    tileMap[TILE_CHAR_BOX] = crateTexture;
-    tileMap[TILE_CHAR_STORAGE] = groundStorageTexture;
-    tileMap[TILE_CHAR_BOX_STORAGE] = crateTexture;
+    tileMap[TileChar::Player] = groundTexture;
+    tileMap[TileChar::Empty] = groundTexture;
+    tileMap[TileChar::Wall] = wallTexture;
+    tileMap[TileChar::Box] = crateTexture;
+    tileMap[TileChar::Storage] = groundStorageTexture;
+    tileMap[TileChar::BoxStorage] = crateTexture;
+    tileMap[TileChar::PlayerStorage] = groundStorageTexture;
 }
 
 void Sokoban::initPlayerTextureMap() {
@@ -193,13 +123,4 @@ void Sokoban::initPlayerTextureMap() {
     playerTextureMap[Direction::Left] = playerLeftTexture;
 }
 
-void Sokoban::setPlayerOrientation(const Direction& direction) {
-    delete player;
-
-    const auto* const texture{ playerTextureMap.at(direction) };
-    auto* const sprite{ new sf::Sprite };
-    sprite->setTexture(*texture);
-    player = sprite;
-}
-
 }  // namespace SB
@@ -28,9 +28,24 @@ int main(const int size, const char* arguments[]) {
                 window.close();
                 break;
             }
+
+            // Move the player, or reset the game
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::W) {
+                    sokoban.movePlayer(SB::Direction::Up);
+                } else if (event.key.code == sf::Keyboard::S) {
+                    sokoban.movePlayer(SB::Direction::Down);
+                } else if (event.key.code == sf::Keyboard::A) {
+                    sokoban.movePlayer(SB::Direction::Left);
+                } else if (event.key.code == sf::Keyboard::D) {
+                    sokoban.movePlayer(SB::Direction::Right);
+                } else if (event.key.code == sf::Keyboard::R) {
+                    sokoban.reset();
+                }
+            }
         }
 
-        sokoban.update(clock.restart().asMilliseconds());
+        sokoban.update(clock.restart().asMicroseconds());
 
         if (window.isOpen()) {
             window.clear();
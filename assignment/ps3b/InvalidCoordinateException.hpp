@@ -4,7 +4,7 @@
 #define INVALIDCOORDINATEEXCEPTION_H
 
 #include <string>
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
 
 namespace SB {
 
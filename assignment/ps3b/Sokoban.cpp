@@ -4,20 +4,36 @@
 #include <algorithm>
 #include <cmath>
 #include <fstream>
-#include <iostream>
-#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include "FrameProfiler.hpp"
+#include "ResourceCache.hpp"
 #include "SokobanConstants.hpp"
 
+namespace {
+
+/**
+ * @brief Creates the texture atlas of a game. The sounds are decoded in the background meanwhile.
+ */
+std::shared_ptr<const SB::SokobanAtlas> make_atlas() {
+    RC::ResourceCache::shared().prefetchSoundBuffers({ SB::SOUND_BACKGROUND, SB::SOUND_WIN });
+    return std::make_shared<const SB::SokobanAtlas>();
+}
+
+}  // namespace
+
 namespace SB {
 
-Sokoban::Sokoban() {
+Sokoban::Sokoban() : Sokoban(make_atlas()) {}
+
+Sokoban::Sokoban(std::shared_ptr<const SokobanAtlas> atlas) :
+    SokobanTileGrid(atlas), SokobanPlayer(atlas) {
     loadSound(SOUND_BACKGROUND);
     loadSound(SOUND_WIN);
 
-    m_font.loadFromFile(FONT_ROBOTO_FILENAME);
+    m_font = RC::ResourceCache::shared().font(FONT_ROBOTO_FILENAME);
 }
 
 Sokoban::Sokoban(const std::string& filename) : Sokoban() {
@@ -29,89 +45,9 @@ Sokoban::Sokoban(const std::string& filename) : Sokoban() {
     ifstream >> *this;
 }
 
-void Sokoban::movePlayer(const Direction& direction) {
-    // If the player has won the game, it can't move anymore
-    if (isWon()) {
-        return;
-    }
-
-    const State state = { m_playerOrientation, m_playerLoc, m_tileCharGrid, m_score };
-
-    // Change the player's orientation
-    m_playerOrientation = direction;
-
-    // Find the coordinate of the block to move to
-    const auto nextLoc{ getNextLoc(m_playerLoc, direction) };
-
-    // If the next location is out of the map, stay on the spot
-    const auto nextLocIndex = getIndex(nextLoc);
-    if (nextLoc.x < 0 || nextLoc.x >= m_width || nextLocIndex < 0 ||
-        nextLocIndex >= m_width * m_height) {
-        return;
-    }
-
-    // Get the texture of the next block
-    const auto nextBlock = getTileChar(nextLoc);
-
-    // If the coordinate corresponds to a wall block or a box storage, stay on the spot
-    if (nextBlock == TileChar::Wall) {
-        return;
-    }
-
-    // If the coordinate corresponds to an box block, try to push the box to the other side
-    if (nextBlock == TileChar::Box || nextBlock == TileChar::BoxStorage) {
-        const auto canMoveBox = moveBox(nextLoc, direction);
-        if (!canMoveBox) {
-            return;
-        }
-    }
-
-    // Save the current move
-    m_stateStack.push(state);
-
-    // Update player location
-    m_playerLoc = nextLoc;
-}
-
 void Sokoban::reset() {
-    // Reset m_hasWon and m_stateStack
+    SokobanGame::reset();
     m_hasWon = false;
-    while (!m_stateStack.empty()) {
-        m_stateStack.pop();
-    }
-
-    // Perform a shallow copy for the tile char grid
-    m_tileCharGrid = m_initialTileCharGrid;
-
-    // Traverse the tile grid
-    auto boxCount{ 0 };
-    auto storageCount{ 0 };
-    auto boxStorageCount{ 0 };
-    traverseTileCharGrid([&](auto coordinate, auto tileChar) {
-        m_tileGrid.push_back(getTile(tileChar));
-        if (tileChar == TileChar::Player) {
-            m_playerLoc = coordinate;
-            setTileChar(coordinate, TileChar::Empty);
-        } else if (tileChar == TileChar::Box) {
-            ++boxCount;
-        } else if (tileChar == TileChar::Storage) {
-            ++storageCount;
-        } else if (tileChar == TileChar::BoxStorage) {
-            ++boxStorageCount;
-        }
-
-        return false;
-    });
-
-    // Set the score and max score
-    m_score = boxStorageCount;
-    m_maxScore = std::min(storageCount, boxCount) + boxStorageCount;
-
-    // Reset the player's orientation
-    m_playerOrientation = DEFAULT_ORIENTATION;
-
-    // Reset the time
-    m_elapsedTimeInMicroseconds = 0;
 
     // Reset the background music
     if (m_soundMap.find(SOUND_BACKGROUND) != m_soundMap.end()) {
@@ -119,37 +55,9 @@ void Sokoban::reset() {
     }
 }
 
-void Sokoban::undo() {
-    if (isWon() || m_stateStack.size() == 0) {
-        return;
-    }
-
-    const auto [playerOrientation, playerLoc, tileCharGrid, score] = m_stateStack.top();
-    m_stateStack.pop();
-
-    m_playerOrientation = playerOrientation;
-    m_playerLoc = playerLoc;
-    m_tileCharGrid = tileCharGrid;
-
-    m_tileGrid.clear();
-    traverseTileCharGrid([&](auto coordinate, auto tileChar) {
-        m_tileGrid.push_back(getTile(tileChar));
-        if (tileChar == TileChar::Player) {
-            m_playerLoc = coordinate;
-            setTileChar(coordinate, TileChar::Empty);
-        }
-
-        return false;
-    });
-
-    m_score = score;
-}
-
 void Sokoban::update(const int64_t& dt) {
-    if (!isWon()) {
-        // If the player has won, don't update the elapsed time
-        SokobanElapsedTime::update(dt);
-    }
+    SokobanGame::update(dt);
+    recordStep();
 
     // Check if the player wins the game
     if (!m_hasWon && isWon()) {
@@ -170,51 +78,37 @@ void Sokoban::update(const int64_t& dt) {
     }
 }
 
-std::ifstream& operator>>(std::ifstream& ifstream, Sokoban& sokoban) {
-    sokoban.m_initialTileCharGrid.clear();
-
-    // The first line consists of height and width; ignore the rest of the line
-    ifstream >> sokoban.m_height >> sokoban.m_width;
-    ifstream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    // Continue the read the following lines
-    for (int row{ 0 }; row < sokoban.m_height; ++row) {
-        std::string line;
-        getline(ifstream, line);
-        for (int col{ 0 }; col < sokoban.m_width; ++col) {
-            sokoban.m_initialTileCharGrid.push_back(static_cast<TileChar>(line.at(col)));
+sf::View Sokoban::cameraView(const sf::Vector2u& targetSize) const {
+    const sf::Vector2f viewSize{ static_cast<float>(targetSize.x),
+                                 static_cast<float>(targetSize.y) };
+    const sf::Vector2f mapSize{ static_cast<float>(m_width * TILE_WIDTH),
+                                static_cast<float>(m_height * TILE_HEIGHT) };
+    const auto playerLoc = playerPosition();
+    const sf::Vector2f playerCenter{ (playerLoc.x + 0.5f) * TILE_WIDTH,
+                                     (playerLoc.y + 0.5f) * TILE_HEIGHT };
+
+    // Keep the player in the center unless the view would go past an edge of the map
+    const auto follow = [](const float center, const float viewLength, const float mapLength) {
+        if (mapLength <= viewLength) {
+            return mapLength / 2.0f;
         }
-    }
 
-    sokoban.reset();
+        return std::clamp(center, viewLength / 2.0f, mapLength - viewLength / 2.0f);
+    };
 
-    return ifstream;
-}
-
-std::ofstream& operator<<(std::ofstream& ofstream, const Sokoban& sokoban) {
-    ofstream << sokoban.height() << sokoban.width();
-
-    const auto player_loc = sokoban.m_playerLoc;
-    sokoban.traverseTileCharGrid([&](auto coordinate, auto tileChar) {
-        if (coordinate.x == 0) {
-            ofstream << std::endl;
-        }
-
-        if (coordinate == player_loc) {
-            ofstream << static_cast<char>(TileChar::Player);
-        } else {
-            ofstream << static_cast<char>(tileChar);
-        }
-
-        return false;
-    });
-
-    return ofstream;
+    return sf::View{ { follow(playerCenter.x, viewSize.x, mapSize.x),
+                       follow(playerCenter.y, viewSize.y, mapSize.y) },
+                     viewSize };
 }
 
 void Sokoban::draw(sf::RenderTarget& target, const sf::RenderStates states) const {
+    // Draw the map and the player through the camera, then restore the view for the overlays
+    const auto overlayView = target.getView();
+    target.setView(cameraView(target.getSize()));
     SokobanTileGrid::draw(target, states);
     SokobanPlayer::draw(target, states);
+    target.setView(overlayView);
+
     SokobanElapsedTime::draw(target, states);
     SokobanScore::draw(target, states);
 
@@ -224,84 +118,26 @@ void Sokoban::draw(sf::RenderTarget& target, const sf::RenderStates states) cons
     }
 }
 
-sf::Vector2i Sokoban::getNextLoc(const sf::Vector2i& currentLoc, const Direction& orientation) {
-    sf::Vector2i nextLoc(currentLoc);
-    switch (orientation) {
-        case Direction::Up:
-            --nextLoc.y;
-            break;
-        case Direction::Down:
-            ++nextLoc.y;
-            break;
-        case Direction::Left:
-            --nextLoc.x;
-            break;
-        case Direction::Right:
-            ++nextLoc.x;
-            break;
-    }
-
-    return nextLoc;
-}
-
-bool Sokoban::moveBox(const sf::Vector2i& fromCoordinate, const Direction& direction) {
-    const auto toCoordinate{ getNextLoc(fromCoordinate, direction) };
-
-    // If the destination coordinate is out of the map, return false
-    const auto toCoordinateIndex = getIndex(toCoordinate);
-    if (toCoordinate.x < 0 || toCoordinate.x >= m_width || toCoordinateIndex < 0 ||
-        toCoordinateIndex >= m_width * m_height) {
-        return false;
-    }
-
-    const auto currentBlock{ getTileChar(fromCoordinate) };
-    const auto nextBlock{ getTileChar(toCoordinate) };
-    const auto isCurrentBlockBoxStorage = currentBlock == TileChar::BoxStorage;
-
-    if (nextBlock == TileChar::Empty) {
-        // Swap the blocks at the initial coordiante and the destination coordinate
-        setTileChar(fromCoordinate, isCurrentBlockBoxStorage ? TileChar::Storage : TileChar::Empty);
-        setTileChar(toCoordinate, TileChar::Box);
-
-        if (isCurrentBlockBoxStorage)
-            --m_score;
-
-        return true;
-    }
-
-    if (nextBlock == TileChar::Storage) {
-        // The block at the initial coordiante should become an empty block (or a storage block if
-        // the current block is a box-storage block); the block at the destination coordinate should
-        // become a box-storage block
-        setTileChar(fromCoordinate, isCurrentBlockBoxStorage ? TileChar::Storage : TileChar::Empty);
-        setTileChar(toCoordinate, TileChar::BoxStorage);
-
-        // Score increments by 1
-        if (!isCurrentBlockBoxStorage)
-            ++m_score;
-
-        return true;
+void Sokoban::loadSound(const std::string& soundFilename) {
+    // A sound that fails to load is left out of the map, so it is never played
+    const auto soundBuffer = RC::ResourceCache::shared().soundBuffer(soundFilename);
+    if (soundBuffer->getSampleCount() == 0) {
+        return;
     }
 
-    return false;
-}
-
-void Sokoban::loadSound(const std::string& soundFilename) {
-    const auto soundBuffer{ std::make_shared<sf::SoundBuffer>() };
     const auto sound{ std::make_shared<sf::Sound>() };
-    if (soundBuffer->loadFromFile(soundFilename)) {
-        sound->setBuffer(*soundBuffer);
-        m_soundMap[soundFilename] = std::make_pair(sound, soundBuffer);
-    }
+    sound->setBuffer(*soundBuffer);
+    m_soundMap[soundFilename] = std::make_pair(sound, soundBuffer);
 }
 
 void Sokoban::drawResultScreen(sf::RenderTarget& target, sf::RenderStates states) const {
     // Draw "You win!" in the center of the screen
     sf::Text winText;
     winText.setString("You win!");
-    winText.setFont(m_font);
+    winText.setFont(*m_font);
     winText.setFillColor(sf::Color(255, 140, 0));
-    winText.setCharacterSize(15 * m_width);
+    const auto visibleColumns = static_cast<int>(target.getSize().x) / TILE_WIDTH;
+    winText.setCharacterSize(15 * visibleColumns);
     winText.setOutlineColor(sf::Color::White);
     winText.setOutlineThickness(2);
 
@@ -313,9 +149,10 @@ void Sokoban::drawResultScreen(sf::RenderTarget& target, sf::RenderStates states
                         (static_cast<float>(winTextRect.height)) });
     winText.setPosition({ targetWidth / 2.0f, targetHeight / 2.0f });
     target.draw(winText);
+    FP::countDrawCall();
 
     // Final score
-    const auto moveScore = m_width * m_height - m_stateStack.size();
+    const auto moveScore = m_width * m_height - moveCount();
     const auto timeInSeconds = static_cast<double>(m_elapsedTimeInMicroseconds) / 1000000.0;
     const auto timeScore = std::exp(1 - timeInSeconds / std::exp(2));
     const auto finalScore = static_cast<int>(std::floor(moveScore * timeScore * m_score));
@@ -323,9 +160,9 @@ void Sokoban::drawResultScreen(sf::RenderTarget& target, sf::RenderStates states
     // Draw the score down below the "You win!"
     sf::Text scoreText;
     scoreText.setString("Score: " + std::to_string(finalScore));
-    scoreText.setFont(m_font);
+    scoreText.setFont(*m_font);
     scoreText.setFillColor(sf::Color::Black);
-    scoreText.setCharacterSize(3 * m_width);
+    scoreText.setCharacterSize(3 * visibleColumns);
     scoreText.setOutlineColor(sf::Color::White);
     winText.setOutlineThickness(2);
 
@@ -335,6 +172,7 @@ void Sokoban::drawResultScreen(sf::RenderTarget& target, sf::RenderStates states
                           (scoreTextRect.height - static_cast<float>(winTextRect.height)) / 2.0f });
     scoreText.setPosition({ targetWidth / 2.0f, targetHeight / 2.0f });
     target.draw(scoreText);
+    FP::countDrawCall();
 }
 
 }  // namespace SB
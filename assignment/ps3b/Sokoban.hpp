@@ -3,17 +3,15 @@
 #ifndef SOKOBAN_H
 #define SOKOBAN_H
 
-#include <functional>
 #include <memory>
-#include <stack>
 #include <string>
 #include <unordered_map>
 #include <utility>
-#include <vector>
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 #include "SokobanConstants.hpp"
 #include "SokobanElapsedTime.hpp"
+#include "SokobanGame.hpp"
 #include "SokobanPlayer.hpp"
 #include "SokobanScore.hpp"
 #include "SokobanTileGrid.hpp"
@@ -21,17 +19,8 @@
 namespace SB {
 
 /**
- * @brief Game state.
- */
-struct State {
-    Direction playerOrientation;
-    sf::Vector2i playerLoc;
-    std::vector<TileChar> tileCharGrid;
-    int score;
-};
-
-/**
- * @brief This class implements all gameplay.
+ * @brief This class implements all gameplay on top of the headless game: it draws the game and
+ * plays the sounds.
  */
 class Sokoban final : public SokobanTileGrid,
                       public SokobanPlayer,
@@ -39,7 +28,7 @@ class Sokoban final : public SokobanTileGrid,
                       public SokobanScore {
  public:
     /**
-     * @brief Creates a Sokoban instance; initializes sound.
+     * @brief Creates a Sokoban instance; initializes the texture atlas and sound.
      */
     Sokoban();
 
@@ -50,20 +39,10 @@ class Sokoban final : public SokobanTileGrid,
     explicit Sokoban(const std::string& filename);
 
     /**
-     * @brief Changes the player's location for one tile with the given direction.
-     * @param direction The direction for the player to move.
-     */
-    void movePlayer(const Direction& direction);
-
-    /**
-     * @brief Resets the game. The game will return back to the initial form.
-     */
-    void reset();
-
-    /**
-     * @brief Undoes one move. If no moves are available to undo, do nothing.
+     * @brief Resets the game. The game will return back to the initial form, and the background
+     * music restarts.
      */
-    void undo();
+    void reset() override;
 
     /**
      * @brief Updates the game in a game frame.
@@ -72,39 +51,25 @@ class Sokoban final : public SokobanTileGrid,
     void update(const int64_t& dt) override;
 
     /**
-     * @brief Reads a map from a level file (.lvl) and loads the content to the sokoban object.
+     * @brief Returns the view of the map for a target of a specified size. The view follows the
+     * player, but never shows the outside of the map; a map smaller than the target is centered.
+     * @param targetSize The size of the target in pixels.
      */
-    friend std::ifstream& operator>>(std::ifstream& ifstream, Sokoban& sokoban);
-
-    /**
-     * @brief Outputs a sokoban game to a level file (.lvl).
-     */
-    friend std::ofstream& operator<<(std::ofstream& ofstream, const Sokoban& sokoban);
+    [[nodiscard]] sf::View cameraView(const sf::Vector2u& targetSize) const;
 
  protected:
     /**
-     * @brief Draws everything onto the target.
+     * @brief Draws everything onto the target. The map and the player are drawn through the
+     * camera view; the elapsed time, the score and the result screen are drawn over them.
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
  private:
     /**
-     * @brief Returns the next location based on the current location and the orientation.
-     * @param currentLoc The current location.
-     * @param orientation The orientation.
+     * @brief Creates a Sokoban instance whose tiles and player share a texture atlas.
+     * @param atlas The texture atlas.
      */
-    [[nodiscard]] static sf::Vector2i
-    getNextLoc(const sf::Vector2i& currentLoc, const Direction& orientation);
-
-    /**
-     * @brief Moves a box towards a specified direction. Note that the block at the from coordinate
-     * must be a box. The box that has already been stowed properly can be moved, and when it is
-     * moved out from the storage, the score decrement.
-     * @param fromCoordinate The initial coordinate.
-     * @param direction The direction to move the box.
-     * @return true if the box can be moved; false otherwise.
-     */
-    bool moveBox(const sf::Vector2i& fromCoordinate, const Direction& direction);
+    explicit Sokoban(std::shared_ptr<const SokobanAtlas> atlas);
 
     /**
      * @brief Loads a sound file.
@@ -128,18 +93,13 @@ class Sokoban final : public SokobanTileGrid,
      */
     std::unordered_map<
         std::string,
-        std::pair<std::shared_ptr<sf::Sound>, std::shared_ptr<sf::SoundBuffer>>>
+        std::pair<std::shared_ptr<sf::Sound>, std::shared_ptr<const sf::SoundBuffer>>>
         m_soundMap;
 
     /**
      * @brief The font for the triumph message.
      */
-    sf::Font m_font;
-
-    /**
-     * @brief The stack of states.
-     */
-    std::stack<State> m_stateStack;
+    std::shared_ptr<const sf::Font> m_font;
 };
 
 }  // namespace SB
@@ -0,0 +1,75 @@
+// Copyright 2024 James Chen
+
+#include "SokobanAtlas.hpp"
+#include <string>
+#include <vector>
+#include "ResourceCache.hpp"
+
+namespace SB {
+
+SokobanAtlas::SokobanAtlas() {
+    // The images to pack, one slot each, from left to right
+    const std::vector<std::string> filenames{
+        TILE_GROUND_01_FILENAME, TILE_GROUND_04_FILENAME, TILE_BLOCK_06_FILENAME,
+        TILE_CRATE_03_FILENAME,  TILE_PLAYER_08_FILENAME, TILE_PLAYER_17_FILENAME,
+        TILE_PLAYER_05_FILENAME, TILE_PLAYER_20_FILENAME,
+    };
+
+    // Decode the images in parallel
+    auto& resourceCache = RC::ResourceCache::shared();
+    resourceCache.prefetchImages(filenames);
+
+    sf::Image atlasImage;
+    atlasImage.create(
+        static_cast<unsigned>(filenames.size() * TILE_WIDTH), TILE_HEIGHT, sf::Color::Transparent);
+    std::vector<sf::IntRect> slots;
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        const auto image = resourceCache.image(filenames[i]);
+        atlasImage.copy(*image, static_cast<unsigned>(i * TILE_WIDTH), 0);
+        slots.emplace_back(static_cast<int>(i) * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT);
+    }
+    m_texture.loadFromImage(atlasImage);
+
+    m_tileRectMap[TileChar::Player] = slots[0];
+    m_tileRectMap[TileChar::Empty] = slots[0];
+    m_tileRectMap[TileChar::Storage] = slots[1];
+    m_tileRectMap[TileChar::Wall] = slots[2];
+    m_tileRectMap[TileChar::Box] = slots[3];
+    m_tileRectMap[TileChar::BoxStorage] = slots[3];
+    m_tileRectMap[TileChar::PlayerStorage] = slots[1];
+
+    m_playerRectMap[Direction::Up] = slots[4];
+    m_playerRectMap[Direction::Right] = slots[5];
+    m_playerRectMap[Direction::Down] = slots[6];
+    m_playerRectMap[Direction::Left] = slots[7];
+}
+
+const sf::Texture& SokobanAtlas::texture() const { return m_texture; }
+
+const sf::IntRect& SokobanAtlas::tileRect(const TileChar tileChar) const {
+    return m_tileRectMap.at(tileChar);
+}
+
+const sf::IntRect& SokobanAtlas::playerRect(const Direction direction) const {
+    return m_playerRectMap.at(direction);
+}
+
+void SokobanAtlas::setQuad(
+    sf::Vertex* quad, const sf::Vector2f& position, const sf::IntRect& textureRect) {
+    const auto width = static_cast<float>(textureRect.width);
+    const auto height = static_cast<float>(textureRect.height);
+    const auto left = static_cast<float>(textureRect.left);
+    const auto top = static_cast<float>(textureRect.top);
+
+    quad[0].position = position;
+    quad[1].position = { position.x + width, position.y };
+    quad[2].position = { position.x + width, position.y + height };
+    quad[3].position = { position.x, position.y + height };
+
+    quad[0].texCoords = { left, top };
+    quad[1].texCoords = { left + width, top };
+    quad[2].texCoords = { left + width, top + height };
+    quad[3].texCoords = { left, top + height };
+}
+
+}  // namespace SB
@@ -0,0 +1,68 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANATLAS_HPP
+#define SOKOBANATLAS_HPP
+
+#include <unordered_map>
+#include <SFML/Graphics.hpp>
+#include "SokobanConstants.hpp"
+
+namespace SB {
+
+/**
+ * @brief A texture atlas that packs the tileset into a single texture, one tile-sized slot for
+ * each image in a row. Tiles and player sprites are drawn by texture rectangles in the atlas, so
+ * that drawing them needs no texture switch and the tiles can be batched into one vertex array.
+ */
+class SokobanAtlas {
+ public:
+    /**
+     * @brief Creates an atlas; loads the tileset images and packs them into the atlas texture.
+     */
+    SokobanAtlas();
+
+    /**
+     * @brief Returns the atlas texture.
+     */
+    [[nodiscard]] const sf::Texture& texture() const;
+
+    /**
+     * @brief Returns the rectangle in the atlas texture of the tile for a specified tile char.
+     */
+    [[nodiscard]] const sf::IntRect& tileRect(TileChar tileChar) const;
+
+    /**
+     * @brief Returns the rectangle in the atlas texture of the player facing a specified direction.
+     */
+    [[nodiscard]] const sf::IntRect& playerRect(Direction direction) const;
+
+    /**
+     * @brief Sets the four vertices of a quad, which draws a specified rectangle of the atlas at a
+     * specified position.
+     * @param quad The first of the four vertices.
+     * @param position The position of the upper-left corner of the quad in pixel.
+     * @param textureRect The rectangle in the atlas texture.
+     */
+    static void
+    setQuad(sf::Vertex* quad, const sf::Vector2f& position, const sf::IntRect& textureRect);
+
+ private:
+    /**
+     * @brief The atlas texture.
+     */
+    sf::Texture m_texture;
+
+    /**
+     * @brief Associates tile chars with their rectangles in the atlas texture.
+     */
+    std::unordered_map<TileChar, sf::IntRect> m_tileRectMap;
+
+    /**
+     * @brief Associates directions with the rectangles of the player sprites in the atlas texture.
+     */
+    std::unordered_map<Direction, sf::IntRect> m_playerRectMap;
+};
+
+}  // namespace SB
+
+#endif
@@ -3,6 +3,7 @@
 #ifndef SOKOBANCONSTANTS_H
 #define SOKOBANCONSTANTS_H
 
+#include <array>
 #include <string>
 
 /**
@@ -24,6 +25,13 @@ inline const std::string AUTHOR_NAME = "James Chen";
 inline constexpr int TILE_HEIGHT = 64;
 inline constexpr int TILE_WIDTH = 64;
 
+// The width and height in tiles of each chunk of the tile layer; only the visible chunks are drawn
+inline constexpr int CHUNK_SIZE = 32;
+
+// The maximum width and height in tiles of the window; larger maps scroll with the player
+inline constexpr int MAX_WINDOW_COLUMNS = 20;
+inline constexpr int MAX_WINDOW_ROWS = 12;
+
 // Tile characters. In the level (.lvl) files, each character corresponds to a specific texture of
 // has particular meaning to the corresponding position.
 // '@' - The initial position of the player.
@@ -32,12 +40,14 @@ inline constexpr int TILE_WIDTH = 64;
 // 'A' - A box, which can be paused by the player.
 // 'a' - A storage location, where the player is trying to push a box.
 // '1' - A box that is already in a storage location.
+// '+' - The initial position of the player, which is a storage location.
 inline constexpr char TILE_CHAR_PLYAER = '@';
 inline constexpr char TILE_CHAR_EMPTY = '.';
 inline constexpr char TILE_CHAR_WALL = '#';
 inline constexpr char TILE_CHAR_BOX = 'A';
 inline constexpr char TILE_CHAR_STORAGE = 'a';
 inline constexpr char TILE_CHAR_BOX_STORAGE = '1';
+inline constexpr char TILE_CHAR_PLAYER_STORAGE = '+';
 
 // Assets directory
 inline const std::string ASSETS_DIR = "./assets/";
@@ -79,6 +89,29 @@ inline const std::string SOUND_WIN = SOUND_DIR + "win.wav";
  */
 enum class Direction { Up, Down, Left, Right };
 
+// All four directions, in the order of the enumeration
+inline constexpr std::array<Direction, 4> DIRECTIONS = {
+    Direction::Up, Direction::Down, Direction::Left, Direction::Right
+};
+
+/**
+ * @brief Returns the opposite of a direction.
+ */
+[[nodiscard]] constexpr Direction opposite(const Direction direction) {
+    switch (direction) {
+        case Direction::Up:
+            return Direction::Down;
+        case Direction::Down:
+            return Direction::Up;
+        case Direction::Left:
+            return Direction::Right;
+        case Direction::Right:
+            return Direction::Left;
+    }
+
+    return direction;
+}
+
 /**
  * @brief Enumerates tile characters.
  */
@@ -89,6 +122,7 @@ enum class TileChar : char {
     Box = TILE_CHAR_BOX,
     Storage = TILE_CHAR_STORAGE,
     BoxStorage = TILE_CHAR_BOX_STORAGE,
+    PlayerStorage = TILE_CHAR_PLAYER_STORAGE,
 };
 
 }  // namespace SB
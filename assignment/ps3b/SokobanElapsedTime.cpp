@@ -2,11 +2,14 @@
 
 #include "SokobanElapsedTime.hpp"
 #include <string>
+#include "FrameProfiler.hpp"
+#include "ResourceCache.hpp"
 #include "SokobanConstants.hpp"
 
 namespace SB {
 
-SokobanElapsedTime::SokobanElapsedTime() { m_font.loadFromFile(FONT_DIGITAL7_FILENAME); }
+SokobanElapsedTime::SokobanElapsedTime() :
+    m_font(RC::ResourceCache::shared().font(FONT_DIGITAL7_FILENAME)) {}
 
 void SokobanElapsedTime::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     const unsigned seconds = m_elapsedTimeInMicroseconds / 1000000u;
@@ -20,14 +23,13 @@ void SokobanElapsedTime::draw(sf::RenderTarget& target, sf::RenderStates states)
     const std::string stringToPrint = hourStr + ":" + minuteStr + ":" + secondStr;
 
     sf::Text text;
-    text.setFont(m_font);
+    text.setFont(*m_font);
     text.setString(stringToPrint);
     text.setCharacterSize(28);
     text.setFillColor(sf::Color::Black);
     text.setPosition(15, 10);
     target.draw(text);
+    FP::countDrawCall();
 }
 
-void SokobanElapsedTime::update(const int64_t& dt) { m_elapsedTimeInMicroseconds += dt; }
-
 }  // namespace SB
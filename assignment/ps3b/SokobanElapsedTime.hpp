@@ -3,41 +3,32 @@
 #ifndef SOKOBANELAPSEDTIME_H
 #define SOKOBANELAPSEDTIME_H
 
+#include <memory>
 #include <SFML/Graphics.hpp>
+#include "SokobanGame.hpp"
 
 namespace SB {
 
 /**
- * @brief This class manages the elapsed time system in Sokoban.
+ * @brief This class draws the elapsed time of a game.
  */
-class SokobanElapsedTime : virtual public sf::Drawable {
+class SokobanElapsedTime : virtual public sf::Drawable, virtual public SokobanGame {
  public:
     /**
      * @brief Creates a SokobanElapsedTime instance: initializes the font.
      */
     SokobanElapsedTime();
 
-    /**
-     * @brief Updates the game in a game frame. This will update the elapsed time.
-     * @param dt The delta time in microseconds between this frame and the previous frame.
-     */
-    virtual void update(const int64_t& dt);
-
  protected:
     /**
      * @brief Draws the elapsed time in the format of "H:MM:SS" in the upper-left corner.
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
-    /**
-     * @brief The elasped time in microseconds.
-     */
-    int64_t m_elapsedTimeInMicroseconds = 0;
-
     /**
      * @brief The font for the diplayed text.
      */
-    sf::Font m_font;
+    std::shared_ptr<const sf::Font> m_font;
 };
 
 }  // namespace SB
@@ -0,0 +1,396 @@
+// Copyright 2024 James Chen
+
+#include "SokobanGame.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "InvalidCoordinateException.hpp"
+
+namespace SB {
+
+SokobanGame::SokobanGame(const std::string& filename) {
+    std::ifstream ifstream{ filename };
+    if (!ifstream.is_open()) {
+        throw std::invalid_argument("File not found: " + filename);
+    }
+
+    ifstream >> *this;
+}
+
+SokobanGame::SokobanGame(const int width, const int height, std::vector<TileChar> tileCharGrid)
+    : m_width(width), m_height(height), m_initialTileCharGrid(std::move(tileCharGrid)) {
+    if (width <= 0 || height <= 0 ||
+        m_initialTileCharGrid.size() != static_cast<std::size_t>(width * height)) {
+        throw std::invalid_argument("The tile char grid does not match the size of the level.");
+    }
+
+    loadLevel();
+}
+
+int SokobanGame::width() const { return m_width; }
+
+int SokobanGame::height() const { return m_height; }
+
+TileChar SokobanGame::getTileChar(const sf::Vector2i& coordinate) const {
+    return tileCharAt(checkCoordinate(coordinate));
+}
+
+sf::Vector2u SokobanGame::playerLoc() const {
+    return { static_cast<unsigned>(m_playerLoc.x), static_cast<unsigned>(m_playerLoc.y) };
+}
+
+Direction SokobanGame::playerOrientation() const { return m_playerOrientation; }
+
+int SokobanGame::score() const { return m_score; }
+
+int SokobanGame::maxScore() const { return m_maxScore; }
+
+std::size_t SokobanGame::moveCount() const { return m_journalCursor; }
+
+std::size_t SokobanGame::journalBytes() const { return m_journal.capacity() * sizeof(MoveDelta); }
+
+int64_t SokobanGame::elapsedTime() const { return m_elapsedTimeInMicroseconds; }
+
+bool SokobanGame::isWon() const { return m_score == m_maxScore; }
+
+void SokobanGame::movePlayer(const Direction& direction) {
+    // If the player has won the game, it can't move anymore
+    if (isWon()) {
+        return;
+    }
+
+    const auto previousOrientation = m_playerOrientation;
+    const auto previousScore = m_score;
+
+    // Change the player's orientation
+    m_playerOrientation = direction;
+
+    // Find the block to move to; the border of walls keeps the player inside the map
+    const auto& offset = m_directionOffsets[static_cast<int>(direction)];
+    const auto nextIndex = m_playerIndex + offset.padded;
+    const auto nextBlock = m_tileCharGrid[nextIndex];
+
+    // If the coordinate corresponds to a wall block, stay on the spot
+    if (nextBlock == TileChar::Wall) {
+        return;
+    }
+
+    // If the coordinate corresponds to an box block, try to push the box to the other side
+    const auto hasPushedBox = nextBlock == TileChar::Box || nextBlock == TileChar::BoxStorage;
+    if (hasPushedBox) {
+        const auto canMoveBox = moveBox(nextIndex, offset);
+        if (!canMoveBox) {
+            return;
+        }
+    }
+
+    // Record the current move; the moves that have been undone can no longer be redone
+    const auto journalEnd = m_journal.begin() + static_cast<std::ptrdiff_t>(m_journalCursor);
+    m_journal.erase(journalEnd, m_journal.end());
+    m_journal.push_back({ previousOrientation,
+                          direction,
+                          m_playerIndex,
+                          nextIndex,
+                          hasPushedBox,
+                          nextIndex,
+                          nextIndex + offset.padded,
+                          m_score - previousScore });
+    ++m_journalCursor;
+
+    // Update player location
+    m_playerIndex = nextIndex;
+    m_playerLoc += offset.unit;
+    m_state->movePlayer(getIndex(m_playerLoc));
+    m_isReachabilityStale = true;
+}
+
+void SokobanGame::reset() {
+    // Reset the journal
+    m_journal.clear();
+    m_journalCursor = 0;
+
+    // Copy the initial tile char grid inside a border of walls
+    m_tileCharGrid.assign(static_cast<std::size_t>((m_width + 2) * (m_height + 2)), TileChar::Wall);
+    auto boxCount{ 0 };
+    auto storageCount{ 0 };
+    auto boxStorageCount{ 0 };
+    for (int row = 0; row < m_height; ++row) {
+        for (int col = 0; col < m_width; ++col) {
+            const auto tileChar = m_initialTileCharGrid[col + row * m_width];
+            auto& paddedTileChar = m_tileCharGrid[getPaddedIndex({ col, row })];
+            paddedTileChar = tileChar;
+            if (tileChar == TileChar::Player) {
+                m_playerLoc = { col, row };
+                paddedTileChar = TileChar::Empty;
+            } else if (tileChar == TileChar::PlayerStorage) {
+                m_playerLoc = { col, row };
+                paddedTileChar = TileChar::Storage;
+                ++storageCount;
+            } else if (tileChar == TileChar::Box) {
+                ++boxCount;
+            } else if (tileChar == TileChar::Storage) {
+                ++storageCount;
+            } else if (tileChar == TileChar::BoxStorage) {
+                ++boxStorageCount;
+            }
+        }
+    }
+    m_playerIndex = getPaddedIndex(m_playerLoc);
+    onTileCharGridReset();
+
+    // Create the compact state on top of the board of the level
+    m_state.emplace(m_board, m_initialTileCharGrid, getIndex(m_playerLoc));
+    m_isReachabilityStale = true;
+
+    // Set the score and max score
+    m_score = boxStorageCount;
+    m_maxScore = std::min(storageCount, boxCount) + boxStorageCount;
+
+    // Reset the player's orientation
+    m_playerOrientation = DEFAULT_ORIENTATION;
+
+    // Reset the time
+    m_elapsedTimeInMicroseconds = 0;
+}
+
+void SokobanGame::load(const SokobanGame& level) {
+    m_width = level.m_width;
+    m_height = level.m_height;
+    m_initialTileCharGrid = level.m_initialTileCharGrid;
+    loadLevel();
+}
+
+void SokobanGame::undo() {
+    if (isWon() || m_journalCursor == 0) {
+        return;
+    }
+
+    // Apply the move in reverse
+    const auto& delta = m_journal[--m_journalCursor];
+    if (delta.hasPushedBox) {
+        relocateBox(delta.boxTo, delta.boxFrom);
+    }
+
+    m_playerIndex = delta.playerFrom;
+    m_playerLoc = getPaddedCoordinate(m_playerIndex);
+    m_state->movePlayer(getIndex(m_playerLoc));
+    m_playerOrientation = delta.previousOrientation;
+    m_score -= delta.scoreChange;
+    m_isReachabilityStale = true;
+}
+
+void SokobanGame::redo() {
+    if (isWon() || m_journalCursor == m_journal.size()) {
+        return;
+    }
+
+    // Apply the move again
+    const auto& delta = m_journal[m_journalCursor++];
+    if (delta.hasPushedBox) {
+        relocateBox(delta.boxFrom, delta.boxTo);
+    }
+
+    m_playerIndex = delta.playerTo;
+    m_playerLoc = getPaddedCoordinate(m_playerIndex);
+    m_state->movePlayer(getIndex(m_playerLoc));
+    m_playerOrientation = delta.orientation;
+    m_score += delta.scoreChange;
+    m_isReachabilityStale = true;
+}
+
+void SokobanGame::update(const int64_t& dt) {
+    // If the player has won, don't update the elapsed time
+    if (!isWon()) {
+        m_elapsedTimeInMicroseconds += dt;
+    }
+}
+
+SokobanReplay SokobanGame::replay() const {
+    std::vector<Direction> moves;
+    moves.reserve(m_journalCursor);
+    for (std::size_t i = 0; i < m_journalCursor; ++i) {
+        moves.push_back(m_journal[i].orientation);
+    }
+
+    return SokobanReplay{ moves };
+}
+
+const SokobanState& SokobanGame::state() const { return *m_state; }
+
+std::shared_ptr<const SokobanLevelAnalysis> SokobanGame::analysis() const {
+    if (!m_analysis) {
+        m_analysis = std::make_shared<const SokobanLevelAnalysis>(*m_board);
+    }
+
+    return m_analysis;
+}
+
+const SokobanReachability& SokobanGame::reachability() const {
+    if (m_isReachabilityStale) {
+        m_reachability.compute(*m_state);
+        m_isReachabilityStale = false;
+    }
+
+    return m_reachability;
+}
+
+bool SokobanGame::isReachable(const sf::Vector2i& coordinate) const {
+    return reachability().isReachable(checkCoordinate(coordinate));
+}
+
+bool SokobanGame::isDeadSquare(const sf::Vector2i& coordinate) const {
+    return analysis()->isDeadSquare(checkCoordinate(coordinate));
+}
+
+std::ifstream& operator>>(std::ifstream& ifstream, SokobanGame& game) {
+    game.m_initialTileCharGrid.clear();
+
+    // The first line consists of height and width; ignore the rest of the line
+    ifstream >> game.m_height >> game.m_width;
+    ifstream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    // Continue the read the following lines
+    for (int row{ 0 }; row < game.m_height; ++row) {
+        std::string line;
+        getline(ifstream, line);
+        for (int col{ 0 }; col < game.m_width; ++col) {
+            game.m_initialTileCharGrid.push_back(static_cast<TileChar>(line.at(col)));
+        }
+    }
+
+    game.loadLevel();
+
+    return ifstream;
+}
+
+std::ostream& operator<<(std::ostream& ostream, const SokobanGame& game) {
+    ostream << game.height() << ' ' << game.width();
+
+    const auto player_loc = game.m_playerLoc;
+    game.traverseTileCharGrid([&](auto coordinate, auto tileChar) {
+        if (coordinate.x == 0) {
+            ostream << std::endl;
+        }
+
+        if (coordinate == player_loc) {
+            const auto isStorage = tileChar == TileChar::Storage;
+            ostream << static_cast<char>(isStorage ? TileChar::PlayerStorage : TileChar::Player);
+        } else {
+            ostream << static_cast<char>(tileChar);
+        }
+
+        return false;
+    });
+
+    return ostream;
+}
+
+int SokobanGame::getIndex(const sf::Vector2i& coordinate) const {
+    return coordinate.x + coordinate.y * m_width;
+}
+
+int SokobanGame::getPaddedIndex(const sf::Vector2i& coordinate) const {
+    return coordinate.x + 1 + (coordinate.y + 1) * (m_width + 2);
+}
+
+TileChar SokobanGame::tileCharAt(const int index) const {
+    return m_tileCharGrid[index % m_width + 1 + (index / m_width + 1) * (m_width + 2)];
+}
+
+int SokobanGame::checkCoordinate(const sf::Vector2i& coordinate) const {
+    if (coordinate.x < 0 || coordinate.x >= m_width || coordinate.y < 0 ||
+        coordinate.y >= m_height) {
+        throw InvalidCoordinateException(coordinate);
+    }
+
+    return getIndex(coordinate);
+}
+
+void SokobanGame::traverseTileCharGrid(
+    const std::function<bool(sf::Vector2i, TileChar)>& callback) const {
+    auto stopIteration = false;
+    for (int row = 0; !stopIteration && row < m_height; ++row) {
+        for (int col = 0; !stopIteration && col < m_width; ++col) {
+            const auto tileChar = m_tileCharGrid[getPaddedIndex({ col, row })];
+            stopIteration = callback({ col, row }, tileChar);
+        }
+    }
+}
+
+void SokobanGame::onTileCharChanged(int) {}
+
+void SokobanGame::onTileCharGridReset() {}
+
+int SokobanGame::getUnpaddedIndex(const int paddedIndex) const {
+    const auto paddedWidth = m_width + 2;
+
+    return paddedIndex % paddedWidth - 1 + (paddedIndex / paddedWidth - 1) * m_width;
+}
+
+sf::Vector2i SokobanGame::getPaddedCoordinate(const int paddedIndex) const {
+    const auto paddedWidth = m_width + 2;
+
+    return { paddedIndex % paddedWidth - 1, paddedIndex / paddedWidth - 1 };
+}
+
+bool SokobanGame::moveBox(const int fromIndex, const DirectionOffset& offset) {
+    // The box can only be pushed to an empty block or a storage block; the border of walls keeps
+    // the box inside the map
+    const auto toIndex = fromIndex + offset.padded;
+    const auto nextBlock = m_tileCharGrid[toIndex];
+    if (nextBlock != TileChar::Empty && nextBlock != TileChar::Storage) {
+        return false;
+    }
+
+    // The score decrements when the box leaves a storage, and increments when the box enters one
+    if (m_tileCharGrid[fromIndex] == TileChar::BoxStorage) {
+        --m_score;
+    }
+    if (nextBlock == TileChar::Storage) {
+        ++m_score;
+    }
+
+    relocateBox(fromIndex, toIndex);
+
+    return true;
+}
+
+void SokobanGame::loadLevel() {
+    // The board is created once per level and shared by all states and solvers
+    m_board = std::make_shared<const SokobanBoard>(m_width, m_height, m_initialTileCharGrid);
+    m_analysis.reset();
+
+    // The offsets of the neighbors depend on the width only
+    const auto paddedWidth = m_width + 2;
+    m_directionOffsets = { {
+        { -paddedWidth, { 0, -1 } },
+        { paddedWidth, { 0, 1 } },
+        { -1, { -1, 0 } },
+        { 1, { 1, 0 } },
+    } };
+
+    reset();
+}
+
+void SokobanGame::relocateBox(const int fromIndex, const int toIndex) {
+    // The block at the initial index should become an empty block (or a storage block if it is a
+    // storage); the block at the destination index should become a box block (or a box-storage
+    // block if it is a storage)
+    auto& fromTileChar = m_tileCharGrid[fromIndex];
+    auto& toTileChar = m_tileCharGrid[toIndex];
+    fromTileChar = fromTileChar == TileChar::BoxStorage ? TileChar::Storage : TileChar::Empty;
+    toTileChar = toTileChar == TileChar::Storage ? TileChar::BoxStorage : TileChar::Box;
+
+    const auto fromUnpaddedIndex = getUnpaddedIndex(fromIndex);
+    const auto toUnpaddedIndex = getUnpaddedIndex(toIndex);
+    m_state->moveBox(fromUnpaddedIndex, toUnpaddedIndex);
+    onTileCharChanged(fromUnpaddedIndex);
+    onTileCharChanged(toUnpaddedIndex);
+}
+
+}  // namespace SB
@@ -0,0 +1,415 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANGAME_HPP
+#define SOKOBANGAME_HPP
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "SokobanConstants.hpp"
+#include "SokobanLevelAnalysis.hpp"
+#include "SokobanReachability.hpp"
+#include "SokobanReplay.hpp"
+#include "SokobanState.hpp"
+
+namespace SB {
+
+/**
+ * @brief A journal entry that records the changes made by one move, so that the move can be undone
+ * and redone without copying the tile char grid. The locations are indices of the padded tile char
+ * grid.
+ */
+struct MoveDelta {
+    Direction previousOrientation;
+    Direction orientation;
+    int playerFrom;
+    int playerTo;
+    bool hasPushedBox;
+    int boxFrom;
+    int boxTo;
+    int scoreChange;
+};
+
+/**
+ * @brief This class implements the gameplay without any graphics, sound or assets: the tile grid,
+ * the player, the score, the elapsed time and the move journal. It only depends on the header-only
+ * vector type of SFML, so solvers, tests and batch tools can create and copy games cheaply. The
+ * SFML classes that draw a game derive from it virtually and share one game.
+ */
+class SokobanGame {
+ public:
+    /**
+     * @brief Creates an empty game; a level should be loaded with operator>>.
+     */
+    SokobanGame() = default;
+
+    /**
+     * @brief A convenient constructor that loads a specified level file.
+     * @param filename The filename of a level file.
+     * @throws std::invalid_argument if the file cannot be opened.
+     */
+    explicit SokobanGame(const std::string& filename);
+
+    /**
+     * @brief Creates a game of a level that is built in memory, such as a generated level.
+     * @param width The number of tile columns.
+     * @param height The number of tile rows.
+     * @param tileCharGrid The tile characters in row-major order; exactly one of them should be the
+     * player.
+     * @throws std::invalid_argument if the size of the grid does not match the width and height.
+     */
+    SokobanGame(int width, int height, std::vector<TileChar> tileCharGrid);
+
+    virtual ~SokobanGame() = default;
+
+    /**
+     * @brief Returns the width of the game board, which is the number of tile columns.
+     */
+    [[nodiscard]] int width() const;
+
+    /**
+     * @brief Returns the height of the game board, which is the number of the tile rows.
+     */
+    [[nodiscard]] int height() const;
+
+    /**
+     * @brief Returns the tile character at a specified coordinate.
+     * @param coordinate The coordinate of the tile character to get.
+     * @throws InvalidCoordinateException if the coordinate is invalid.
+     */
+    [[nodiscard]] TileChar getTileChar(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Returns the players' current position; (0, 0) represents the upper-left cell in the
+     * upper-left corner.
+     */
+    [[nodiscard]] sf::Vector2u playerLoc() const;
+
+    /**
+     * @brief Returns the direction that the player faces.
+     */
+    [[nodiscard]] Direction playerOrientation() const;
+
+    /**
+     * @brief Returns the player's current score, which is the number of boxes in storages.
+     */
+    [[nodiscard]] int score() const;
+
+    /**
+     * @brief Returns the score to win the current level.
+     */
+    [[nodiscard]] int maxScore() const;
+
+    /**
+     * @brief Returns the number of moves that have been made, excluding the ones undone.
+     */
+    [[nodiscard]] std::size_t moveCount() const;
+
+    /**
+     * @brief Returns the number of bytes retained by the move journal, including the moves that
+     * have been undone and the capacity reserved for future moves.
+     */
+    [[nodiscard]] std::size_t journalBytes() const;
+
+    /**
+     * @brief Returns the elapsed time in microseconds.
+     */
+    [[nodiscard]] int64_t elapsedTime() const;
+
+    /**
+     * @brief Checks if the player has won the game.
+     * @return True if the player has won the game; false otherwise.
+     */
+    [[nodiscard]] bool isWon() const;
+
+    /**
+     * @brief Changes the player's location for one tile with the given direction. The neighbors are
+     * found with precomputed offsets on the padded tile char grid, so no bounds are checked.
+     * @param direction The direction for the player to move.
+     */
+    void movePlayer(const Direction& direction);
+
+    /**
+     * @brief Resets the game. The game will return back to the initial form.
+     */
+    virtual void reset();
+
+    /**
+     * @brief Loads the initial form of the level of another game, and resets this game; the other
+     * game is usually a level of a level pack.
+     * @param level The game of the level to load.
+     */
+    void load(const SokobanGame& level);
+
+    /**
+     * @brief Undoes one move. If no moves are available to undo, do nothing.
+     */
+    void undo();
+
+    /**
+     * @brief Redoes one move that has been undone. If no moves are available to redo, do nothing.
+     * Making a new move discards all the moves that are available to redo.
+     */
+    void redo();
+
+    /**
+     * @brief Updates the game in a game frame. This will update the elapsed time unless the player
+     * has won.
+     * @param dt The delta time in microseconds between this frame and the previous frame.
+     */
+    virtual void update(const int64_t& dt);
+
+    /**
+     * @brief Returns a replay of the moves that have been made, excluding the ones undone. Moves
+     * that are blocked by walls or boxes are not recorded.
+     */
+    [[nodiscard]] SokobanReplay replay() const;
+
+    /**
+     * @brief Returns the current state in the compact form. Note that a level must be loaded.
+     */
+    [[nodiscard]] const SokobanState& state() const;
+
+    /**
+     * @brief Returns the analysis of the current level. It is computed on the first call after the
+     * level is loaded, since its tables grow with the number of storages times the number of
+     * tiles, and playing a large map does not need it.
+     */
+    [[nodiscard]] std::shared_ptr<const SokobanLevelAnalysis> analysis() const;
+
+    /**
+     * @brief Returns the region that the player can reach without pushing a box in the current
+     * state. It is computed on demand and reused until the player moves.
+     */
+    [[nodiscard]] const SokobanReachability& reachability() const;
+
+    /**
+     * @brief Returns whether the player can walk to a specified coordinate without pushing a box.
+     * @param coordinate The coordinate of the tile.
+     * @throws InvalidCoordinateException if the coordinate is invalid.
+     */
+    [[nodiscard]] bool isReachable(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Returns whether a box at a specified coordinate can never be pushed into a storage.
+     * @param coordinate The coordinate of the tile.
+     * @throws InvalidCoordinateException if the coordinate is invalid.
+     */
+    [[nodiscard]] bool isDeadSquare(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Reads a map from a level file (.lvl) and loads the content to the game.
+     */
+    friend std::ifstream& operator>>(std::ifstream& ifstream, SokobanGame& game);
+
+    /**
+     * @brief Outputs a game in the format of a level file (.lvl); a player in a storage is written
+     * as '+'.
+     */
+    friend std::ostream& operator<<(std::ostream& ostream, const SokobanGame& game);
+
+ protected:
+    /**
+     * @brief The player's default orientation.
+     */
+    inline static Direction DEFAULT_ORIENTATION = Direction::Down;
+
+    /**
+     * @brief Returns the corresponding index of a specified coordiante.
+     * @param coordinate Coordinate to analyze.
+     */
+    [[nodiscard]] int getIndex(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Returns the corresponding index of a specified coordinate in the padded tile char
+     * grid.
+     * @param coordinate Coordinate to analyze.
+     */
+    [[nodiscard]] int getPaddedIndex(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Returns the tile character at a specified index without any checks.
+     * @param index The index of the tile in row-major order, without the padding.
+     */
+    [[nodiscard]] TileChar tileCharAt(int index) const;
+
+    /**
+     * @brief Checks if a specified coordinate is valid. A valid coordiante should be inside the
+     * map.
+     * @param coordinate The coordinate to check.
+     * @return A index corresponding to the coordinate.
+     * @throws InvalidCoordinateException if the coordinate is invalid.
+     */
+    [[nodiscard]] int checkCoordinate(const sf::Vector2i& coordinate) const;
+
+    /**
+     * @brief Iterates over each tile character in the grid and invokes the specified callback
+     * function for each tile, providing the tile's coordinate and its associated tile character.
+     * The callback function should return false to continue the traversal or true to stop it.
+     * @param callback The callback function is to be invoked for each tile.
+     */
+    void traverseTileCharGrid(const std::function<bool(sf::Vector2i, TileChar)>& callback) const;
+
+    /**
+     * @brief Invoked after the tile char at a specified index changes. Views override it to update
+     * what they draw; the default implementation does nothing.
+     */
+    virtual void onTileCharChanged(int index);
+
+    /**
+     * @brief Invoked after the whole tile char grid is replaced, which happens when the game is
+     * reset. The default implementation does nothing.
+     */
+    virtual void onTileCharGridReset();
+
+    /**
+     * @brief The number of tile columns.
+     */
+    int m_width = 0;
+
+    /**
+     * @brief The number of tile rows.
+     */
+    int m_height = 0;
+
+    /**
+     * @brief The initial tile char grid. It is unchanged until the level changes.
+     */
+    std::vector<TileChar> m_initialTileCharGrid;
+
+    /**
+     * @brief Represents the tile character grid, which is mapping into an one-dimentional array in
+     * row-major order. The grid is padded with a border of walls, so it has (m_width + 2) columns
+     * and (m_height + 2) rows, and every tile inside the map has four neighbors.
+     */
+    std::vector<TileChar> m_tileCharGrid;
+
+    /**
+     * @brief Player location. Note the unit of this coordinate is tile instead of pixel.
+     */
+    sf::Vector2i m_playerLoc = { 0, 0 };
+
+    /**
+     * @brief Player's current orientation. The default orientation is down.
+     */
+    Direction m_playerOrientation = DEFAULT_ORIENTATION;
+
+    /**
+     * @brief The player's current score. Players get one score when they successfully put a box to
+     * a storage. In a word, the score is equals to the number of "StorageBox" block in the map.
+     */
+    int m_score = 0;
+
+    /**
+     * @brief The player's max score in the current level. The player wins the game when the score
+     * equals the max score.
+     */
+    int m_maxScore = 1;
+
+    /**
+     * @brief The elasped time in microseconds.
+     */
+    int64_t m_elapsedTimeInMicroseconds = 0;
+
+ private:
+    /**
+     * @brief The offsets of the neighbor in a direction: the offset of the index in the padded
+     * tile char grid and the unit vector.
+     */
+    struct DirectionOffset {
+        int padded;
+        sf::Vector2i unit;
+    };
+
+    /**
+     * @brief Returns the index without the padding of an index of the padded tile char grid.
+     */
+    [[nodiscard]] int getUnpaddedIndex(int paddedIndex) const;
+
+    /**
+     * @brief Returns the coordinate of an index of the padded tile char grid.
+     */
+    [[nodiscard]] sf::Vector2i getPaddedCoordinate(int paddedIndex) const;
+
+    /**
+     * @brief Moves a box towards a specified direction. Note that the block at the from index must
+     * be a box. The box that has already been stowed properly can be moved, and when it is moved
+     * out from the storage, the score decrement.
+     * @param fromIndex The index of the box in the padded tile char grid.
+     * @param offset The offsets of the direction to move the box.
+     * @return true if the box can be moved; false otherwise.
+     */
+    bool moveBox(int fromIndex, const DirectionOffset& offset);
+
+    /**
+     * @brief Creates the board of the initial tile char grid, drops the analysis of the previous
+     * level, and resets the game. It is invoked whenever a level is loaded.
+     */
+    void loadLevel();
+
+    /**
+     * @brief Relocates a box without any checks; the tile chars at both indices and the compact
+     * state are updated. The score is left to the caller.
+     * @param fromIndex The index of the box in the padded tile char grid.
+     * @param toIndex The index to put the box in the padded tile char grid.
+     */
+    void relocateBox(int fromIndex, int toIndex);
+
+    /**
+     * @brief The offsets of the four directions, in the order of the enumeration.
+     */
+    std::array<DirectionOffset, 4> m_directionOffsets{};
+
+    /**
+     * @brief The index of the player in the padded tile char grid.
+     */
+    int m_playerIndex = 0;
+
+    /**
+     * @brief The board of the current level, which is shared by all compact states.
+     */
+    std::shared_ptr<const SokobanBoard> m_board;
+
+    /**
+     * @brief The analysis of the current level; it is computed on demand and shared by the copies
+     * of the game made afterwards.
+     */
+    mutable std::shared_ptr<const SokobanLevelAnalysis> m_analysis;
+
+    /**
+     * @brief The current state in the compact form; it is updated along with the tile char grid.
+     */
+    std::optional<SokobanState> m_state;
+
+    /**
+     * @brief The reachability of the current state; its buffers are reused between computations.
+     */
+    mutable SokobanReachability m_reachability;
+
+    /**
+     * @brief Whether the reachability must be computed again, since the player has moved.
+     */
+    mutable bool m_isReachabilityStale = true;
+
+    /**
+     * @brief The journal of moves. The first m_journalCursor entries are the moves that have been
+     * made; the rest are the moves that have been undone and can be redone.
+     */
+    std::vector<MoveDelta> m_journal;
+
+    /**
+     * @brief The number of moves that have been made, excluding the ones that have been undone.
+     */
+    std::size_t m_journalCursor = 0;
+};
+
+}  // namespace SB
+
+#endif
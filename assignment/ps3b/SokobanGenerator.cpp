@@ -0,0 +1,219 @@
+// Copyright 2024 James Chen
+
+#include "SokobanGenerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Returns the index of the neighbor of a tile in a grid towards a specified direction. The
+ * tile must not be on the border of the grid.
+ */
+int neighbor_index(const int index, const int width, const SB::Direction direction) {
+    switch (direction) {
+        case SB::Direction::Up:
+            return index - width;
+        case SB::Direction::Down:
+            return index + width;
+        case SB::Direction::Left:
+            return index - 1;
+        case SB::Direction::Right:
+            return index + 1;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Turns every floor tile that cannot be reached from a specified tile into a wall, so that
+ * the floor of the room is connected.
+ * @return The number of floor tiles left.
+ */
+int keep_connected_floor(std::vector<bool>& isFloor, const int width, const int start) {
+    std::vector<bool> isVisited(isFloor.size(), false);
+    std::vector<int> stack{ start };
+    isVisited[start] = true;
+    auto floorCount = 0;
+    while (!stack.empty()) {
+        const auto index = stack.back();
+        stack.pop_back();
+        ++floorCount;
+        for (const auto direction : SB::DIRECTIONS) {
+            const auto next = neighbor_index(index, width, direction);
+            if (isFloor[next] && !isVisited[next]) {
+                isVisited[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < isFloor.size(); ++i) {
+        isFloor[i] = isFloor[i] && isVisited[i];
+    }
+
+    return floorCount;
+}
+
+}  // namespace
+
+namespace SB {
+
+SokobanGenerator::SokobanGenerator(const int width, const int height, const int boxCount)
+    : m_width(width), m_height(height), m_boxCount(boxCount) {
+    // The room inside the walls needs a tile for the player besides the boxes
+    if (boxCount < 1 || width < 3 || height < 3 || (width - 2) * (height - 2) <= boxCount) {
+        throw std::invalid_argument("The room is too small for the boxes.");
+    }
+}
+
+GeneratedLevel SokobanGenerator::generateCandidate(const uint64_t seed, const uint64_t maxNodes)
+    const {
+    std::mt19937_64 random{ seed };
+    std::uniform_real_distribution<double> probability{ 0.0, 1.0 };
+    GeneratedLevel level;
+    level.seed = seed;
+
+    // Build a room: the border is a wall, and the tiles inside are walls at random
+    const auto size = m_width * m_height;
+    std::vector<bool> isFloor(size, false);
+    std::vector<int> floorTiles;
+    for (int row = 1; row < m_height - 1; ++row) {
+        for (int col = 1; col < m_width - 1; ++col) {
+            if (probability(random) >= WALL_DENSITY) {
+                isFloor[col + row * m_width] = true;
+                floorTiles.push_back(col + row * m_width);
+            }
+        }
+    }
+    if (floorTiles.empty()) {
+        return level;
+    }
+
+    // Keep the floor that is connected to a random tile, so that the player can reach every tile
+    const auto start = floorTiles[random() % floorTiles.size()];
+    if (keep_connected_floor(isFloor, m_width, start) <= m_boxCount * 2) {
+        return level;
+    }
+    const auto isWall = [&isFloor](const int index) { return !isFloor[index]; };
+    const auto floorEnd = std::remove_if(floorTiles.begin(), floorTiles.end(), isWall);
+    floorTiles.erase(floorEnd, floorTiles.end());
+
+    // Put the boxes in random storages, and the player on another tile
+    std::shuffle(floorTiles.begin(), floorTiles.end(), random);
+    std::vector<bool> isStorage(size, false);
+    std::vector<bool> isBox(size, false);
+    for (int i = 0; i < m_boxCount; ++i) {
+        isStorage[floorTiles[i]] = true;
+        isBox[floorTiles[i]] = true;
+    }
+    auto player = floorTiles[m_boxCount];
+
+    // Walk the player at random; when the player steps away from a box behind it, the box may be
+    // pulled along. A pull is the reverse of a push, so the boxes can always be pushed back.
+    for (int step = 0; step < WALK_STEPS_PER_BOX * m_boxCount; ++step) {
+        const auto direction = DIRECTIONS[random() % DIRECTIONS.size()];
+        const auto next = neighbor_index(player, m_width, direction);
+        if (!isFloor[next] || isBox[next]) {
+            continue;
+        }
+
+        const auto behind = player + (player - next);
+        if (isBox[behind] && probability(random) < PULL_PROBABILITY) {
+            isBox[behind] = false;
+            isBox[player] = true;
+        }
+        player = next;
+    }
+
+    std::vector<TileChar> tileCharGrid(size, TileChar::Wall);
+    for (int i = 0; i < size; ++i) {
+        if (i == player) {
+            tileCharGrid[i] = isStorage[i] ? TileChar::PlayerStorage : TileChar::Player;
+        } else if (isBox[i]) {
+            tileCharGrid[i] = isStorage[i] ? TileChar::BoxStorage : TileChar::Box;
+        } else if (isStorage[i]) {
+            tileCharGrid[i] = TileChar::Storage;
+        } else if (isFloor[i]) {
+            tileCharGrid[i] = TileChar::Empty;
+        }
+    }
+    level.game = SokobanGame{ m_width, m_height, std::move(tileCharGrid) };
+    if (level.game.isWon()) {
+        return level;
+    }
+
+    // Measure the difficulty by the effort of the solver
+    const SokobanSolver solver{ level.game.state(), level.game.analysis() };
+    const auto solution = solver.solve(maxNodes);
+    level.isSolved = solution.isSolved;
+    level.pushes = static_cast<int>(solution.pushes.size());
+    level.expandedNodes = solution.statistics.expandedNodes;
+
+    return level;
+}
+
+std::vector<GeneratedLevel> SokobanGenerator::generate(
+    const std::size_t count,
+    const DifficultyBand& band,
+    const int threadCount,
+    const uint64_t firstSeed,
+    const uint64_t maxCandidates) const {
+    if (threadCount < 1) {
+        throw std::invalid_argument("The number of threads must be positive.");
+    }
+
+    // The seeds are handed out in order until enough levels are accepted. Every seed handed out is
+    // tried, so the tried seeds are always a prefix of the sequence, and the accepted levels with
+    // the smallest seeds are the same as the ones of a single thread.
+    std::atomic<uint64_t> nextCandidate{ 0 };
+    std::atomic<std::size_t> acceptedCount{ 0 };
+    std::mutex levelsMutex;
+    std::vector<GeneratedLevel> levels;
+    const auto work = [&]() {
+        while (acceptedCount.load() < count) {
+            const auto candidate = nextCandidate.fetch_add(1);
+            if (candidate >= maxCandidates) {
+                break;
+            }
+
+            auto level = generateCandidate(firstSeed + candidate, band.maxNodes);
+            if (isInBand(level, band)) {
+                ++acceptedCount;
+                const std::lock_guard<std::mutex> lock{ levelsMutex };
+                levels.push_back(std::move(level));
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::sort(levels.begin(), levels.end(), [](const auto& a, const auto& b) {
+        return a.seed < b.seed;
+    });
+    if (levels.size() > count) {
+        levels.resize(count);
+    }
+
+    return levels;
+}
+
+bool SokobanGenerator::isInBand(const GeneratedLevel& level, const DifficultyBand& band) {
+    return level.isSolved && level.pushes >= band.minPushes && level.pushes <= band.maxPushes &&
+           level.expandedNodes >= band.minNodes && level.expandedNodes <= band.maxNodes;
+}
+
+}  // namespace SB
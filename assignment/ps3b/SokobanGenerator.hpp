@@ -0,0 +1,123 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANGENERATOR_HPP
+#define SOKOBANGENERATOR_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "SokobanGame.hpp"
+#include "SokobanSolver.hpp"
+
+namespace SB {
+
+/**
+ * @brief The range of difficulty of the levels to accept. The difficulty of a level is measured by
+ * the effort of the solver: the fewest pushes to solve it and the number of nodes expanded to find
+ * the solution. Both ranges are inclusive.
+ */
+struct DifficultyBand {
+    int minPushes = 1;
+    int maxPushes = std::numeric_limits<int>::max();
+    uint64_t minNodes = 0;
+    uint64_t maxNodes = SokobanSolver::DEFAULT_MAX_NODES;
+};
+
+/**
+ * @brief A generated level and its difficulty. The level is unsolved if the solver gives up, or
+ * the candidate is rejected before it is solved.
+ */
+struct GeneratedLevel {
+    uint64_t seed = 0;
+    SokobanGame game;
+    bool isSolved = false;
+    int pushes = 0;
+    uint64_t expandedNodes = 0;
+};
+
+/**
+ * @brief This class generates Sokoban levels. A candidate level is a room of random walls; the
+ * boxes are placed in the storages, and the player pulls them away with a random walk. Since every
+ * pull can be undone by a push, the level can always be solved, and the solver measures how
+ * difficult it is.
+ */
+class SokobanGenerator {
+ public:
+    /**
+     * @brief Creates a generator of levels of a specified size.
+     * @param width The number of tile columns, including the walls around the room.
+     * @param height The number of tile rows, including the walls around the room.
+     * @param boxCount The number of boxes (and storages).
+     * @throws std::invalid_argument if the room is too small for the boxes.
+     */
+    SokobanGenerator(int width, int height, int boxCount);
+
+    /**
+     * @brief Generates a candidate level from a specified seed and solves it. The same seed always
+     * generates the same level.
+     * @param seed The seed of the random number generator.
+     * @param maxNodes The maximum number of nodes for the solver to expand.
+     */
+    [[nodiscard]] GeneratedLevel
+    generateCandidate(uint64_t seed, uint64_t maxNodes = SokobanSolver::DEFAULT_MAX_NODES) const;
+
+    /**
+     * @brief Generates levels in a difficulty band with several threads. The candidates are
+     * generated from the seeds firstSeed, firstSeed + 1, ..., and the accepted levels with the
+     * smallest seeds are returned in order of their seeds, so the result does not depend on the
+     * number of threads.
+     * @param count The number of levels to generate.
+     * @param band The difficulty band of the levels to accept.
+     * @param threadCount The number of threads.
+     * @param firstSeed The seed of the first candidate.
+     * @param maxCandidates The maximum number of candidates to try before giving up; fewer levels
+     * are returned if it is reached.
+     * @throws std::invalid_argument if the number of threads is not positive.
+     */
+    [[nodiscard]] std::vector<GeneratedLevel> generate(
+        std::size_t count,
+        const DifficultyBand& band,
+        int threadCount,
+        uint64_t firstSeed,
+        uint64_t maxCandidates) const;
+
+    /**
+     * @brief Returns whether a generated level is in a difficulty band.
+     */
+    [[nodiscard]] static bool isInBand(const GeneratedLevel& level, const DifficultyBand& band);
+
+ private:
+    /**
+     * @brief The probability for a tile inside the room to be a wall.
+     */
+    static constexpr double WALL_DENSITY = 0.2;
+
+    /**
+     * @brief The number of steps of the random walk for each box.
+     */
+    static constexpr int WALK_STEPS_PER_BOX = 300;
+
+    /**
+     * @brief The probability for the player to pull a box behind it in a step.
+     */
+    static constexpr double PULL_PROBABILITY = 0.6;
+
+    /**
+     * @brief The number of tile columns.
+     */
+    int m_width;
+
+    /**
+     * @brief The number of tile rows.
+     */
+    int m_height;
+
+    /**
+     * @brief The number of boxes.
+     */
+    int m_boxCount;
+};
+
+}  // namespace SB
+
+#endif
@@ -0,0 +1,68 @@
+// Copyright 2024 James Chen
+
+#include "SokobanLevelAnalysis.hpp"
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace SB {
+
+SokobanLevelAnalysis::SokobanLevelAnalysis(const SokobanBoard& board) : m_size(board.size()) {
+    for (int i = 0; i < m_size; ++i) {
+        if (board.isStorage(i)) {
+            m_storages.push_back(i);
+        }
+    }
+
+    m_distances.assign(m_storages.size() * m_size, UNREACHABLE);
+    m_nearestDistances.assign(m_size, UNREACHABLE);
+
+    // Returns whether a tile is a wall or out of the map
+    const auto isBlocked = [&](const int index) { return index < 0 || board.isWall(index); };
+
+    for (std::size_t s = 0; s < m_storages.size(); ++s) {
+        const auto distances = m_distances.begin() + static_cast<std::ptrdiff_t>(s * m_size);
+        std::queue<int> queue;
+        distances[m_storages[s]] = 0;
+        queue.push(m_storages[s]);
+
+        // The box at `to` is pulled to `from`, and the player steps further towards the direction
+        while (!queue.empty()) {
+            const auto to = queue.front();
+            queue.pop();
+            for (const auto direction : DIRECTIONS) {
+                const auto from = board.neighbor(to, direction);
+                if (isBlocked(from) || distances[from] != UNREACHABLE) {
+                    continue;
+                }
+
+                if (isBlocked(board.neighbor(from, direction))) {
+                    continue;
+                }
+
+                distances[from] = distances[to] + 1;
+                queue.push(from);
+            }
+        }
+
+        for (int i = 0; i < m_size; ++i) {
+            m_nearestDistances[i] = std::min(m_nearestDistances[i], distances[i]);
+        }
+    }
+}
+
+const std::vector<int>& SokobanLevelAnalysis::storages() const { return m_storages; }
+
+int SokobanLevelAnalysis::distance(const int storageOrdinal, const int index) const {
+    return m_distances[storageOrdinal * m_size + index];
+}
+
+int SokobanLevelAnalysis::nearestDistance(const int index) const {
+    return m_nearestDistances[index];
+}
+
+bool SokobanLevelAnalysis::isDeadSquare(const int index) const {
+    return m_nearestDistances[index] == UNREACHABLE;
+}
+
+}  // namespace SB
@@ -0,0 +1,81 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANLEVELANALYSIS_HPP
+#define SOKOBANLEVELANALYSIS_HPP
+
+#include <vector>
+#include "SokobanState.hpp"
+
+namespace SB {
+
+/**
+ * @brief The facts of a level that never change during a game: the push distances from every tile
+ * to every storage and the dead squares, which are the tiles that a box can never leave for a
+ * storage. The analysis is computed once when a level is loaded, so that move validation and
+ * search heuristics are table lookups.
+ */
+class SokobanLevelAnalysis {
+ public:
+    /**
+     * @brief The distance to a storage that a box can never reach.
+     */
+    static constexpr int UNREACHABLE = 1000000;
+
+    /**
+     * @brief Analyzes the level of a board with a reverse BFS from each storage. A box is pulled
+     * backwards from the storage: a box at one tile could have been pushed from its neighbor if
+     * the player could stand on the other side of the neighbor. Boxes are ignored.
+     * @param board The board to analyze.
+     */
+    explicit SokobanLevelAnalysis(const SokobanBoard& board);
+
+    /**
+     * @brief Returns the indices of the storages in ascending order.
+     */
+    [[nodiscard]] const std::vector<int>& storages() const;
+
+    /**
+     * @brief Returns the fewest pushes to move a box from a tile to a storage, ignoring the other
+     * boxes; returns UNREACHABLE if it is impossible.
+     * @param storageOrdinal The ordinal of the storage in storages().
+     * @param index The index of the tile.
+     */
+    [[nodiscard]] int distance(int storageOrdinal, int index) const;
+
+    /**
+     * @brief Returns the fewest pushes to move a box from a tile to the nearest storage; returns
+     * UNREACHABLE if the tile is a dead square.
+     */
+    [[nodiscard]] int nearestDistance(int index) const;
+
+    /**
+     * @brief Returns whether a box at a specified index can never reach any storage.
+     */
+    [[nodiscard]] bool isDeadSquare(int index) const;
+
+ private:
+    /**
+     * @brief The number of tiles.
+     */
+    int m_size;
+
+    /**
+     * @brief The indices of the storages.
+     */
+    std::vector<int> m_storages;
+
+    /**
+     * @brief The push distances; the distances to the storage s are stored in m_distances[s *
+     * m_size, (s + 1) * m_size).
+     */
+    std::vector<int> m_distances;
+
+    /**
+     * @brief The push distance from each tile to the nearest storage.
+     */
+    std::vector<int> m_nearestDistances;
+};
+
+}  // namespace SB
+
+#endif
@@ -0,0 +1,226 @@
+// Copyright 2024 James Chen
+
+#include "SokobanLevelPack.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Returns whether a line of a level pack is a row of a level: it consists of level
+ * characters only and has at least one wall.
+ */
+bool is_level_row(const std::string_view line) {
+    constexpr std::string_view levelChars = "#@+$*.-_ ";
+    return line.find('#') != std::string_view::npos &&
+           line.find_first_not_of(levelChars) == std::string_view::npos;
+}
+
+/**
+ * @brief Removes the leading and trailing spaces (and a carriage return) of a string.
+ */
+std::string_view trim(const std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Converts a character of the standard level format to a tile char.
+ */
+SB::TileChar to_tile_char(const char c) {
+    switch (c) {
+        case '#':
+            return SB::TileChar::Wall;
+        case '.':
+            return SB::TileChar::Storage;
+        case '$':
+            return SB::TileChar::Box;
+        case '*':
+            return SB::TileChar::BoxStorage;
+        case '@':
+            return SB::TileChar::Player;
+        case '+':
+            return SB::TileChar::PlayerStorage;
+        default:
+            return SB::TileChar::Empty;
+    }
+}
+
+/**
+ * @brief Turns every empty tile that can be reached from the border of a grid without crossing a
+ * wall into a wall, so that the outside of a level is not drawn as a floor.
+ */
+void fill_outside(std::vector<SB::TileChar>& tileCharGrid, const int width, const int height) {
+    std::vector<int> stack;
+    const auto visit = [&](const int index) {
+        if (tileCharGrid[index] == SB::TileChar::Empty) {
+            tileCharGrid[index] = SB::TileChar::Wall;
+            stack.push_back(index);
+        }
+    };
+    for (int col = 0; col < width; ++col) {
+        visit(col);
+        visit(col + (height - 1) * width);
+    }
+    for (int row = 0; row < height; ++row) {
+        visit(row * width);
+        visit(width - 1 + row * width);
+    }
+
+    while (!stack.empty()) {
+        const auto index = stack.back();
+        stack.pop_back();
+        const auto col = index % width;
+        const auto row = index / width;
+        if (row > 0) {
+            visit(index - width);
+        }
+        if (row < height - 1) {
+            visit(index + width);
+        }
+        if (col > 0) {
+            visit(index - 1);
+        }
+        if (col < width - 1) {
+            visit(index + 1);
+        }
+    }
+}
+
+}  // namespace
+
+namespace SB {
+
+SokobanLevelPack::SokobanLevelPack(const std::string& filename) {
+    const auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("File not found: " + filename);
+    }
+
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw std::invalid_argument("Failed to read the file: " + filename);
+    }
+
+    // An empty file cannot be mapped, and it has no levels anyway
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::invalid_argument("Failed to map the file: " + filename);
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    close(fd);
+
+    indexLevels();
+}
+
+SokobanLevelPack::~SokobanLevelPack() {
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+std::size_t SokobanLevelPack::size() const { return m_levels.size(); }
+
+const std::string& SokobanLevelPack::title(const std::size_t index) const {
+    return entry(index).title;
+}
+
+SokobanGame SokobanLevelPack::load(const std::size_t index) const {
+    const auto& level = entry(index);
+    const std::string_view text{ m_data + level.offset, level.length };
+
+    // Short rows are filled with empty tiles, which are outside of the walls
+    std::vector<TileChar> tileCharGrid(
+        static_cast<std::size_t>(level.width * level.height), TileChar::Empty);
+    auto playerCount = 0;
+    std::size_t lineStart = 0;
+    for (int row = 0; row < level.height; ++row) {
+        const auto lineEnd = std::min(text.find('\n', lineStart), text.size());
+        const auto line = text.substr(lineStart, lineEnd - lineStart);
+        for (std::size_t col = 0; col < line.size() && line[col] != '\r'; ++col) {
+            const auto tileChar = to_tile_char(line[col]);
+            if (tileChar == TileChar::Player || tileChar == TileChar::PlayerStorage) {
+                ++playerCount;
+            }
+            tileCharGrid[col + row * level.width] = tileChar;
+        }
+        lineStart = lineEnd + 1;
+    }
+
+    if (playerCount != 1) {
+        throw std::invalid_argument("The level should have exactly one player: " + level.title);
+    }
+
+    fill_outside(tileCharGrid, level.width, level.height);
+
+    return SokobanGame{ level.width, level.height, std::move(tileCharGrid) };
+}
+
+void SokobanLevelPack::indexLevels() {
+    const std::string_view text{ m_data, m_size };
+    std::string lastComment;
+    auto isAfterLevel = false;
+    std::size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        const auto lineEnd = std::min(text.find('\n', lineStart), text.size());
+        const auto line = text.substr(lineStart, lineEnd - lineStart);
+        const auto trimmedLine = trim(line);
+
+        if (is_level_row(line.substr(0, line.find_last_not_of('\r') + 1))) {
+            // A row right after a row of the same level extends it; otherwise a new level begins
+            if (!isAfterLevel) {
+                const auto number = std::to_string(m_levels.size() + 1);
+                auto title = lastComment.empty() ? "Level " + number : std::move(lastComment);
+                m_levels.push_back({ lineStart, 0, 0, 0, std::move(title) });
+                lastComment.clear();
+                isAfterLevel = true;
+            }
+
+            auto& level = m_levels.back();
+            const auto width = static_cast<int>(line.find_last_not_of(" \r") + 1);
+            level.length = lineEnd - level.offset;
+            level.width = std::max(level.width, width);
+            ++level.height;
+        } else {
+            // A title after a level names the level; a comment before a level names the next one
+            constexpr std::string_view titlePrefix = "Title:";
+            if (trimmedLine.substr(0, titlePrefix.size()) == titlePrefix && !m_levels.empty() &&
+                lastComment.empty()) {
+                m_levels.back().title = trim(trimmedLine.substr(titlePrefix.size()));
+            } else if (!trimmedLine.empty() && trimmedLine.front() == ';') {
+                lastComment = trim(trimmedLine.substr(1));
+            }
+
+            isAfterLevel = false;
+        }
+
+        lineStart = lineEnd + 1;
+    }
+}
+
+const SokobanLevelPack::LevelEntry& SokobanLevelPack::entry(const std::size_t index) const {
+    if (index >= m_levels.size()) {
+        throw std::out_of_range("Level index out of range: " + std::to_string(index));
+    }
+
+    return m_levels[index];
+}
+
+}  // namespace SB
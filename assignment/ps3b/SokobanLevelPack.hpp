@@ -0,0 +1,108 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANLEVELPACK_HPP
+#define SOKOBANLEVELPACK_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SokobanGame.hpp"
+
+namespace SB {
+
+/**
+ * @brief This class reads a level pack, which is a text file of many levels in the standard
+ * Sokoban format:
+ *   '#' - A wall.
+ *   ' ', '-' or '_' - An empty space.
+ *   '.' - A storage location.
+ *   '$' - A box.
+ *   '*' - A box in a storage location.
+ *   '@' - The player.
+ *   '+' - The player in a storage location.
+ * Levels are separated by lines of other text, such as blank lines, comments (starting with ';')
+ * and titles ("Title: ..."). The file is memory-mapped, and only the bounds of the levels are
+ * indexed when it is opened; a level is parsed when it is loaded.
+ */
+class SokobanLevelPack {
+ public:
+    /**
+     * @brief Opens a level pack and indexes its levels.
+     * @param filename The filename of the level pack.
+     * @throws std::invalid_argument if the file cannot be opened or mapped.
+     */
+    explicit SokobanLevelPack(const std::string& filename);
+
+    SokobanLevelPack(const SokobanLevelPack&) = delete;
+
+    SokobanLevelPack& operator=(const SokobanLevelPack&) = delete;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~SokobanLevelPack();
+
+    /**
+     * @brief Returns the number of levels in this pack.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Returns the title of a level: the text of the "Title:" line after the level, or the
+     * last comment before it; "Level N" if the level has neither.
+     * @param index The index of the level, starting from 0.
+     * @throws std::out_of_range if the index is out of range.
+     */
+    [[nodiscard]] const std::string& title(std::size_t index) const;
+
+    /**
+     * @brief Parses a level and returns a game of it. The tiles outside the walls become walls, and
+     * short rows are filled with walls.
+     * @param index The index of the level, starting from 0.
+     * @throws std::out_of_range if the index is out of range.
+     * @throws std::invalid_argument if the level does not have exactly one player.
+     */
+    [[nodiscard]] SokobanGame load(std::size_t index) const;
+
+ private:
+    /**
+     * @brief The bounds of a level in the file, which are found when the file is indexed.
+     */
+    struct LevelEntry {
+        std::size_t offset;
+        std::size_t length;
+        int width;
+        int height;
+        std::string title;
+    };
+
+    /**
+     * @brief Finds the bounds and titles of all levels in the mapped file.
+     */
+    void indexLevels();
+
+    /**
+     * @brief Returns the entry of a level.
+     * @throws std::out_of_range if the index is out of range.
+     */
+    [[nodiscard]] const LevelEntry& entry(std::size_t index) const;
+
+    /**
+     * @brief The mapped contents of the file; it is null if the file is empty.
+     */
+    const char* m_data = nullptr;
+
+    /**
+     * @brief The size of the file in bytes.
+     */
+    std::size_t m_size = 0;
+
+    /**
+     * @brief The entries of the levels in the order of the file.
+     */
+    std::vector<LevelEntry> m_levels;
+};
+
+}  // namespace SB
+
+#endif
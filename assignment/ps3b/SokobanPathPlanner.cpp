@@ -0,0 +1,325 @@
+// Copyright 2024 James Chen
+
+#include "SokobanPathPlanner.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace SB {
+
+SokobanPathPlanner::SokobanPathPlanner()
+    : SokobanPathPlanner([] {
+          return std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+              .count();
+      }) {}
+
+SokobanPathPlanner::SokobanPathPlanner(Clock clock) : m_clock(std::move(clock)) {}
+
+void SokobanPathPlanner::planWalk(const SokobanGame& game, const sf::Vector2i& target) {
+    // Read the target through the checked API, so that an invalid target throws
+    const auto targetTileChar = game.getTileChar(target);
+    m_isPushing = false;
+    m_isBuildingPath = false;
+    m_state = game.state();
+    m_targetIndex = target.x + target.y * game.width();
+    m_path.clear();
+    m_expansionCount = 0;
+
+    // Walls and boxes can never be walked to
+    if (targetTileChar == TileChar::Wall || m_state->hasBox(m_targetIndex)) {
+        m_status = PlanStatus::Unreachable;
+        return;
+    }
+
+    const auto playerIndex = m_state->playerIndex();
+    startWalk(playerIndex);
+    m_status = playerIndex == m_targetIndex ? PlanStatus::Found : PlanStatus::Searching;
+}
+
+void SokobanPathPlanner::planPush(
+    const SokobanGame& game, const sf::Vector2i& box, const sf::Vector2i& target) {
+    const auto targetTileChar = game.getTileChar(target);
+    static_cast<void>(game.getTileChar(box));
+    m_isPushing = true;
+    m_isBuildingPath = false;
+    m_state = game.state();
+    m_targetIndex = target.x + target.y * game.width();
+    m_boxIndex = box.x + box.y * game.width();
+    m_playerStartIndex = m_state->playerIndex();
+    m_path.clear();
+    m_expansionCount = 0;
+
+    // Only a box can be pushed, and never into a wall or another box
+    const auto isTargetBlocked = targetTileChar == TileChar::Wall ||
+                                 (m_targetIndex != m_boxIndex && m_state->hasBox(m_targetIndex));
+    if (!m_state->hasBox(m_boxIndex) || isTargetBlocked) {
+        m_status = PlanStatus::Unreachable;
+        return;
+    }
+
+    // Start a new generation of the push marks; they are only cleared when it wraps around
+    const auto markCount = static_cast<std::size_t>(m_state->board().size()) * DIRECTIONS.size();
+    if (m_pushStamps.size() != markCount) {
+        m_pushStamps.assign(markCount, 0);
+        m_sideStamps.assign(markCount, 0);
+        m_sideMasks.assign(markCount, 0);
+        m_pushGeneration = 0;
+    }
+    if (++m_pushGeneration == 0) {
+        std::fill(m_pushStamps.begin(), m_pushStamps.end(), 0);
+        std::fill(m_sideStamps.begin(), m_sideStamps.end(), 0);
+        m_pushGeneration = 1;
+    }
+
+    // The root node stands for the box before any push
+    m_pushNodes.clear();
+    m_pushNodes.push_back({ m_boxIndex, Direction::Up, -1 });
+    m_pushHead = 0;
+    m_status = m_boxIndex == m_targetIndex ? PlanStatus::Found : PlanStatus::Searching;
+}
+
+PlanStatus SokobanPathPlanner::advance(const int64_t budgetInMicroseconds) {
+    const auto deadline = m_clock() + budgetInMicroseconds;
+    while (m_status == PlanStatus::Searching) {
+        if (m_isBuildingPath) {
+            m_status = expandPushPath();
+        } else if (m_isPushing ? m_pushHead == m_pushNodes.size()
+                               : m_walkHead == m_walkQueue.size()) {
+            m_status = PlanStatus::Unreachable;
+        } else if (m_isPushing) {
+            if (expandPush()) {
+                startPushPath(static_cast<int>(m_pushNodes.size()) - 1);
+            }
+        } else if (expandWalk(m_targetIndex)) {
+            appendWalkPath(m_targetIndex, m_path);
+            m_status = PlanStatus::Found;
+        }
+
+        // Read the clock every few tiles of a walk only, since reading it costs more than expanding
+        // a tile; a push node may search a region of the map, so the clock is read after each one
+        const auto isPushSearch = m_isPushing && !m_isBuildingPath;
+        const auto expansionsPerClockRead = isPushSearch ? 1 : EXPANSIONS_PER_CLOCK_READ;
+        if (++m_expansionCount % expansionsPerClockRead == 0 && m_clock() >= deadline) {
+            break;
+        }
+    }
+
+    return m_status;
+}
+
+PlanStatus SokobanPathPlanner::status() const { return m_status; }
+
+const std::vector<Direction>& SokobanPathPlanner::path() const { return m_path; }
+
+void SokobanPathPlanner::cancel() {
+    m_status = PlanStatus::Idle;
+    m_isBuildingPath = false;
+    m_path.clear();
+}
+
+uint64_t SokobanPathPlanner::expansionCount() const { return m_expansionCount; }
+
+void SokobanPathPlanner::startWalk(const int fromIndex) {
+    const auto size = static_cast<std::size_t>(m_state->board().size());
+    if (m_walkStamps.size() != size) {
+        m_walkStamps.assign(size, 0);
+        m_walkParents.assign(size, Direction::Up);
+        m_walkGeneration = 0;
+    }
+    if (++m_walkGeneration == 0) {
+        std::fill(m_walkStamps.begin(), m_walkStamps.end(), 0);
+        m_walkGeneration = 1;
+    }
+
+    m_walkQueue.clear();
+    m_walkQueue.push_back(fromIndex);
+    m_walkStamps[fromIndex] = m_walkGeneration;
+    m_walkHead = 0;
+}
+
+bool SokobanPathPlanner::expandWalk(const int targetIndex) {
+    const auto& board = m_state->board();
+    const auto index = m_walkQueue[m_walkHead++];
+    for (const auto direction : DIRECTIONS) {
+        const auto next = board.neighbor(index, direction);
+        if (next < 0 || m_walkStamps[next] == m_walkGeneration || board.isWall(next) ||
+            m_state->hasBox(next)) {
+            continue;
+        }
+
+        m_walkStamps[next] = m_walkGeneration;
+        m_walkParents[next] = direction;
+        m_walkQueue.push_back(next);
+        if (next == targetIndex) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SokobanPathPlanner::expandPush() {
+    const auto& board = m_state->board();
+    const auto node = m_pushNodes[m_pushHead];
+    const auto nodeIndex = static_cast<int>(m_pushHead++);
+
+    // Move the box of the snapshot to the node; the player stands where the box was
+    const auto previousBoxIndex = board.neighbor(node.boxIndex, opposite(node.direction));
+    const auto playerIndex = node.parent < 0 ? m_playerStartIndex : previousBoxIndex;
+    if (node.boxIndex != m_boxIndex) {
+        m_state->moveBox(m_boxIndex, node.boxIndex);
+        m_boxIndex = node.boxIndex;
+    }
+    const auto playerSide = node.parent < 0 ? -1 : static_cast<int>(opposite(node.direction));
+    const auto sides = reachableSides(node.boxIndex, playerIndex, playerSide);
+
+    for (const auto direction : DIRECTIONS) {
+        // The player must be able to stand behind the box, and the box must be pushed to a tile
+        // without a wall or a box
+        const auto isBehindReachable = (sides >> static_cast<int>(opposite(direction)) & 1) != 0;
+        const auto next = board.neighbor(node.boxIndex, direction);
+        if (!isBehindReachable || next < 0 || board.isWall(next) || m_state->hasBox(next)) {
+            continue;
+        }
+
+        auto& stamp = m_pushStamps[next * DIRECTIONS.size() + static_cast<int>(direction)];
+        if (stamp == m_pushGeneration) {
+            continue;
+        }
+
+        stamp = m_pushGeneration;
+        m_pushNodes.push_back({ next, direction, nodeIndex });
+        if (next == m_targetIndex) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint8_t SokobanPathPlanner::reachableSides(
+    const int boxIndex, const int playerIndex, const int playerSide) {
+    const auto sideMarkBase = static_cast<std::size_t>(boxIndex) * DIRECTIONS.size();
+    if (playerSide >= 0 && m_sideStamps[sideMarkBase + playerSide] == m_pushGeneration) {
+        return m_sideMasks[sideMarkBase + playerSide];
+    }
+
+    // The free sides of the box are the ones the search looks for
+    const auto& board = m_state->board();
+    std::array<int, 4> sideIndices{};
+    uint8_t freeSides = 0;
+    uint8_t reachedSides = 0;
+    for (const auto direction : DIRECTIONS) {
+        const auto side = static_cast<int>(direction);
+        const auto index = board.neighbor(boxIndex, direction);
+        sideIndices[side] = index;
+        if (index >= 0 && !board.isWall(index) && !m_state->hasBox(index)) {
+            freeSides |= 1 << side;
+            reachedSides |= index == playerIndex ? 1 << side : 0;
+        }
+    }
+
+    // Start a new generation of the region marks
+    const auto size = static_cast<std::size_t>(board.size());
+    if (m_regionStamps.size() != size) {
+        m_regionStamps.assign(size, 0);
+        m_regionGeneration = 0;
+    }
+    if (++m_regionGeneration == 0) {
+        std::fill(m_regionStamps.begin(), m_regionStamps.end(), 0);
+        m_regionGeneration = 1;
+    }
+
+    // Breadth-first search from the player until every free side is reached or the region is
+    // exhausted
+    m_regionQueue.clear();
+    m_regionQueue.push_back(playerIndex);
+    m_regionStamps[playerIndex] = m_regionGeneration;
+    for (std::size_t head = 0; head < m_regionQueue.size() && reachedSides != freeSides; ++head) {
+        const auto index = m_regionQueue[head];
+        for (const auto direction : DIRECTIONS) {
+            const auto next = board.neighbor(index, direction);
+            if (next < 0 || m_regionStamps[next] == m_regionGeneration || board.isWall(next) ||
+                m_state->hasBox(next)) {
+                continue;
+            }
+
+            m_regionStamps[next] = m_regionGeneration;
+            m_regionQueue.push_back(next);
+            for (int side = 0; side < 4; ++side) {
+                reachedSides |= next == sideIndices[side] ? 1 << side : 0;
+            }
+        }
+    }
+
+    // The reached sides are in the region of the player, so they share the mask
+    for (int side = 0; side < 4; ++side) {
+        if ((reachedSides >> side & 1) != 0) {
+            m_sideStamps[sideMarkBase + side] = m_pushGeneration;
+            m_sideMasks[sideMarkBase + side] = reachedSides;
+        }
+    }
+
+    return reachedSides;
+}
+
+void SokobanPathPlanner::appendWalkPath(const int toIndex, std::vector<Direction>& moves) const {
+    const auto& board = m_state->board();
+    const auto walkStart = moves.size();
+    for (auto index = toIndex; index != m_walkQueue.front();) {
+        const auto direction = m_walkParents[index];
+        moves.push_back(direction);
+        index = board.neighbor(index, opposite(direction));
+    }
+    std::reverse(moves.begin() + static_cast<std::ptrdiff_t>(walkStart), moves.end());
+}
+
+void SokobanPathPlanner::startPushPath(const int goalNode) {
+    m_pushPlan.clear();
+    for (auto i = goalNode; m_pushNodes[i].parent >= 0; i = m_pushNodes[i].parent) {
+        m_pushPlan.push_back(m_pushNodes[i]);
+    }
+    std::reverse(m_pushPlan.begin(), m_pushPlan.end());
+    m_pushPlanCursor = 0;
+    m_isBuildingPath = true;
+
+    // Replay the pushes on the snapshot from the start
+    const auto boxStartIndex = m_pushNodes.front().boxIndex;
+    m_state->moveBox(m_boxIndex, boxStartIndex);
+    m_boxIndex = boxStartIndex;
+    m_state->movePlayer(m_playerStartIndex);
+    startWalk(m_playerStartIndex);
+}
+
+PlanStatus SokobanPathPlanner::expandPushPath() {
+    // Search the walk until the tile behind the box is reached; the start of the walk is stamped
+    const auto& push = m_pushPlan[m_pushPlanCursor];
+    const auto behind = m_state->board().neighbor(m_boxIndex, opposite(push.direction));
+    if (m_walkStamps[behind] != m_walkGeneration) {
+        if (m_walkHead == m_walkQueue.size()) {
+            m_isBuildingPath = false;
+            return PlanStatus::Unreachable;
+        }
+
+        expandWalk(behind);
+        return PlanStatus::Searching;
+    }
+
+    appendWalkPath(behind, m_path);
+    m_path.push_back(push.direction);
+    m_state->moveBox(m_boxIndex, push.boxIndex);
+    m_state->movePlayer(m_boxIndex);
+    m_boxIndex = push.boxIndex;
+    if (++m_pushPlanCursor == m_pushPlan.size()) {
+        m_isBuildingPath = false;
+        return PlanStatus::Found;
+    }
+
+    startWalk(m_state->playerIndex());
+    return PlanStatus::Searching;
+}
+
+}  // namespace SB
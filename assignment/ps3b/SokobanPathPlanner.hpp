@@ -0,0 +1,304 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANPATHPLANNER_HPP
+#define SOKOBANPATHPLANNER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "SokobanConstants.hpp"
+#include "SokobanGame.hpp"
+#include "SokobanState.hpp"
+
+namespace SB {
+
+/**
+ * @brief Enumerates the statuses of a path planner.
+ */
+enum class PlanStatus { Idle, Searching, Found, Unreachable };
+
+/**
+ * @brief This class plans the moves for click-to-move: the shortest walk to a tile, or the fewest
+ * pushes that bring a box to a tile, with the walks between the pushes. The search is a
+ * breadth-first search that can be suspended, so a frame advances it within a time budget and a
+ * large map never stalls the game. The search works on a snapshot of the game, so the plan must be
+ * cancelled if the game changes before it is found.
+ */
+class SokobanPathPlanner {
+ public:
+    /**
+     * @brief The default time budget of advance() in microseconds, which is a quarter of a frame
+     * at 60 frames per second.
+     */
+    static constexpr int64_t DEFAULT_BUDGET_IN_MICROSECONDS = 4000;
+
+    /**
+     * @brief A clock that returns the current time in microseconds.
+     */
+    using Clock = std::function<int64_t()>;
+
+    /**
+     * @brief Creates a planner that measures its time budget with the steady clock.
+     */
+    SokobanPathPlanner();
+
+    /**
+     * @brief Creates a planner that measures its time budget with a specified clock.
+     * @param clock The clock that returns the current time in microseconds.
+     */
+    explicit SokobanPathPlanner(Clock clock);
+
+    /**
+     * @brief Starts planning the shortest walk of the player to a tile without pushing a box.
+     * @param game The game to plan for.
+     * @param target The coordinate of the tile to walk to.
+     * @throws InvalidCoordinateException if the target is invalid.
+     */
+    void planWalk(const SokobanGame& game, const sf::Vector2i& target);
+
+    /**
+     * @brief Starts planning the fewest pushes to move a box to a tile; the other boxes are not
+     * moved.
+     * @param game The game to plan for.
+     * @param box The coordinate of the box to push.
+     * @param target The coordinate of the tile to push the box to.
+     * @throws InvalidCoordinateException if a coordinate is invalid.
+     */
+    void planPush(const SokobanGame& game, const sf::Vector2i& box, const sf::Vector2i& target);
+
+    /**
+     * @brief Continues the search until the plan is found, the target turns out to be unreachable
+     * or the time budget runs out. Once the pushes are found, the walks between them are searched
+     * within the same budget, and the status becomes Found when the complete moves are built. At
+     * least one step is taken, so every call makes progress.
+     * @param budgetInMicroseconds The time budget in microseconds.
+     * @return The status after the search is continued.
+     */
+    PlanStatus advance(int64_t budgetInMicroseconds = DEFAULT_BUDGET_IN_MICROSECONDS);
+
+    /**
+     * @brief Returns the status of the planner.
+     */
+    [[nodiscard]] PlanStatus status() const;
+
+    /**
+     * @brief Returns the planned moves. It is only meaningful when the status is Found.
+     */
+    [[nodiscard]] const std::vector<Direction>& path() const;
+
+    /**
+     * @brief Abandons the current plan; the status becomes Idle.
+     */
+    void cancel();
+
+    /**
+     * @brief Returns the number of steps taken for the current plan: the tiles and the nodes
+     * expanded by the searches and the pushes appended to the path.
+     */
+    [[nodiscard]] uint64_t expansionCount() const;
+
+ private:
+    /**
+     * @brief The number of tiles of the walk search to expand between two reads of the clock. A
+     * node of the push search may search a region of the map, so the clock is read after each one.
+     */
+    static constexpr int EXPANSIONS_PER_CLOCK_READ = 256;
+
+    /**
+     * @brief A node of the push search: the box has been pushed to a tile towards a direction.
+     */
+    struct PushNode {
+        int boxIndex;
+        Direction direction;
+        int parent;
+    };
+
+    /**
+     * @brief Starts a new walk search from a specified tile. The walk marks are resized to the
+     * number of tiles and start a new generation.
+     */
+    void startWalk(int fromIndex);
+
+    /**
+     * @brief Expands the next tile of the walk search. The walk queue must not be exhausted.
+     * @param targetIndex The index of the tile to walk to.
+     * @return true if the target has been reached; false otherwise.
+     */
+    bool expandWalk(int targetIndex);
+
+    /**
+     * @brief Expands the next node of the push search.
+     * @return true if the box has been pushed to the target; false otherwise.
+     */
+    bool expandPush();
+
+    /**
+     * @brief Returns the sides of the box to push that the player can walk to, as a mask with a bit
+     * for each direction from the box. The player stands on one side after a push, and the sides
+     * in the same region share their mask, so it is searched once for each region around each box
+     * tile. The search stops as soon as every free side is reached.
+     * @param boxIndex The index of the box, which has been moved there in the snapshot.
+     * @param playerIndex The index of the player.
+     * @param playerSide The side of the box where the player stands, or -1 if it is not next to
+     * the box.
+     */
+    uint8_t reachableSides(int boxIndex, int playerIndex, int playerSide);
+
+    /**
+     * @brief Appends the directions of the walk from the start of the last walk search to a tile,
+     * following the parent directions.
+     */
+    void appendWalkPath(int toIndex, std::vector<Direction>& moves) const;
+
+    /**
+     * @brief Starts building the complete moves of the push plan that ends at a specified node: the
+     * pushes are replayed on the snapshot from the start, with a walk behind the box before each.
+     */
+    void startPushPath(int goalNode);
+
+    /**
+     * @brief Takes a step of building the push path: expands a tile of the walk behind the box, or
+     * appends the walk and the push once the tile behind the box is reached.
+     * @return Found if the complete moves have been built, Unreachable if the walk behind the box
+     * cannot be found, or Searching otherwise.
+     */
+    PlanStatus expandPushPath();
+
+    /**
+     * @brief The clock that measures the time budget.
+     */
+    Clock m_clock;
+
+    /**
+     * @brief The status of the planner.
+     */
+    PlanStatus m_status = PlanStatus::Idle;
+
+    /**
+     * @brief The number of steps taken for the current plan.
+     */
+    uint64_t m_expansionCount = 0;
+
+    /**
+     * @brief Whether the planner is planning pushes instead of a walk.
+     */
+    bool m_isPushing = false;
+
+    /**
+     * @brief The snapshot of the game. When planning pushes, the box to push is moved around in it.
+     */
+    std::optional<SokobanState> m_state;
+
+    /**
+     * @brief The index of the target tile.
+     */
+    int m_targetIndex = -1;
+
+    /**
+     * @brief The planned moves.
+     */
+    std::vector<Direction> m_path;
+
+    /**
+     * @brief The generation in which each tile was last reached by the walk search.
+     */
+    std::vector<uint32_t> m_walkStamps;
+
+    /**
+     * @brief The generation of the walk search.
+     */
+    uint32_t m_walkGeneration = 0;
+
+    /**
+     * @brief The direction in which each tile was entered by the walk search.
+     */
+    std::vector<Direction> m_walkParents;
+
+    /**
+     * @brief The queue of the walk search; the tiles before m_walkHead have been expanded.
+     */
+    std::vector<int> m_walkQueue;
+
+    /**
+     * @brief The position of the next tile to expand in the walk queue.
+     */
+    std::size_t m_walkHead = 0;
+
+    /**
+     * @brief The generation in which each (tile, direction) pair was last reached by the push
+     * search.
+     */
+    std::vector<uint32_t> m_pushStamps;
+
+    /**
+     * @brief The generation of the push search.
+     */
+    uint32_t m_pushGeneration = 0;
+
+    /**
+     * @brief The nodes of the push search, which is also its queue.
+     */
+    std::vector<PushNode> m_pushNodes;
+
+    /**
+     * @brief The position of the next node to expand in the push nodes.
+     */
+    std::size_t m_pushHead = 0;
+
+    /**
+     * @brief The initial index of the player when planning pushes.
+     */
+    int m_playerStartIndex = -1;
+
+    /**
+     * @brief The index of the box to push in the snapshot.
+     */
+    int m_boxIndex = -1;
+
+    /**
+     * @brief Whether the pushes have been found and the walks between them are being searched.
+     */
+    bool m_isBuildingPath = false;
+
+    /**
+     * @brief The pushes of the found plan in order.
+     */
+    std::vector<PushNode> m_pushPlan;
+
+    /**
+     * @brief The position of the next push to append in the push plan.
+     */
+    std::size_t m_pushPlanCursor = 0;
+
+    /**
+     * @brief The generation in which each (tile, side) pair was given a mask of reachable sides, in
+     * the generation of the push search.
+     */
+    std::vector<uint32_t> m_sideStamps;
+
+    /**
+     * @brief The masks of the reachable sides for each (tile, side) pair of the box to push.
+     */
+    std::vector<uint8_t> m_sideMasks;
+
+    /**
+     * @brief The generation in which each tile was last reached by the search of reachable sides.
+     */
+    std::vector<uint32_t> m_regionStamps;
+
+    /**
+     * @brief The generation of the search of reachable sides.
+     */
+    uint32_t m_regionGeneration = 0;
+
+    /**
+     * @brief The queue of the search of reachable sides.
+     */
+    std::vector<int> m_regionQueue;
+};
+
+}  // namespace SB
+
+#endif
@@ -1,51 +1,44 @@
 // Copyright 2024 James Chen
 
 #include "SokobanPlayer.hpp"
+#include <cstdlib>
 #include <memory>
+#include <utility>
+#include "FrameProfiler.hpp"
 
 namespace SB {
 
-SokobanPlayer::SokobanPlayer() {
-    const auto playerUpTexture{ std::make_shared<sf::Texture>() };
-    const auto playerRightTexture{ std::make_shared<sf::Texture>() };
-    const auto playerDownTexture{ std::make_shared<sf::Texture>() };
-    const auto playerLeftTexture{ std::make_shared<sf::Texture>() };
-    playerUpTexture->loadFromFile(TILE_PLAYER_08_FILENAME);
-    playerRightTexture->loadFromFile(TILE_PLAYER_17_FILENAME);
-    playerDownTexture->loadFromFile(TILE_PLAYER_05_FILENAME);
-    playerLeftTexture->loadFromFile(TILE_PLAYER_20_FILENAME);
-
-    m_playerTextureMap[Direction::Up] = { playerUpTexture };
-    m_playerTextureMap[Direction::Right] = { playerRightTexture };
-    m_playerTextureMap[Direction::Down] = { playerDownTexture };
-    m_playerTextureMap[Direction::Left] = { playerLeftTexture };
-
-    const auto playerUpSprite{ std::make_shared<sf::Sprite>() };
-    const auto playerRightSprite{ std::make_shared<sf::Sprite>() };
-    const auto playerDownSprite{ std::make_shared<sf::Sprite>() };
-    const auto playerLeftSprite{ std::make_shared<sf::Sprite>() };
-    playerUpSprite->setTexture(*playerUpTexture);
-    playerRightSprite->setTexture(*playerRightTexture);
-    playerDownSprite->setTexture(*playerDownTexture);
-    playerLeftSprite->setTexture(*playerLeftTexture);
-
-    m_playerSpriteMap[Direction::Up] = playerUpSprite;
-    m_playerSpriteMap[Direction::Right] = playerRightSprite;
-    m_playerSpriteMap[Direction::Down] = playerDownSprite;
-    m_playerSpriteMap[Direction::Left] = playerLeftSprite;
-}
+SokobanPlayer::SokobanPlayer(std::shared_ptr<const SokobanAtlas> atlas) :
+    m_playerAtlas(std::move(atlas)) {}
 
 void SokobanPlayer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    const auto player = m_playerSpriteMap.at(m_playerOrientation);
-    player->setPosition({
-        static_cast<float>(m_playerLoc.x * TILE_WIDTH),
-        static_cast<float>(m_playerLoc.y * TILE_HEIGHT),
-    });
-    target.draw(*player);
+    sf::Sprite player{ m_playerAtlas->texture(), m_playerAtlas->playerRect(m_playerOrientation) };
+    const auto position = playerPosition();
+    player.setPosition({ position.x * TILE_WIDTH, position.y * TILE_HEIGHT });
+    target.draw(player, states);
+    FP::countDrawCall();
+}
+
+void SokobanPlayer::setInterpolation(const float interpolation) { m_interpolation = interpolation; }
+
+void SokobanPlayer::recordStep() {
+    m_previousStepPlayerLoc = m_lastStepPlayerLoc;
+    m_lastStepPlayerLoc = m_playerLoc;
 }
 
-sf::Vector2u SokobanPlayer::playerLoc() const {
-    return { static_cast<unsigned>(m_playerLoc.x), static_cast<unsigned>(m_playerLoc.y) };
+sf::Vector2f SokobanPlayer::playerPosition() const {
+    const sf::Vector2f current{ static_cast<float>(m_playerLoc.x),
+                                static_cast<float>(m_playerLoc.y) };
+
+    // The player has moved outside of the steps, or jumped more than a tile in the last step
+    const auto offset = m_lastStepPlayerLoc - m_previousStepPlayerLoc;
+    if (m_lastStepPlayerLoc != m_playerLoc || std::abs(offset.x) + std::abs(offset.y) != 1) {
+        return current;
+    }
+
+    const auto remaining = 1.0f - m_interpolation;
+    return { current.x - static_cast<float>(offset.x) * remaining,
+             current.y - static_cast<float>(offset.y) * remaining };
 }
 
 }  // namespace SB
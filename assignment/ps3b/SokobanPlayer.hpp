@@ -4,61 +4,72 @@
 #define SOKOBANPLAYER_HPP
 
 #include <memory>
-#include <unordered_map>
 #include <SFML/Graphics.hpp>
+#include "SokobanAtlas.hpp"
 #include "SokobanConstants.hpp"
+#include "SokobanGame.hpp"
 
 namespace SB {
 
 /**
- * @brief This class manages the player system in Sokoban.
+ * @brief This class draws the player of a game. When the game runs in fixed time steps, the player
+ * is drawn between the positions of the last two steps, so that a move slides smoothly at any frame
+ * rate.
  */
-class SokobanPlayer : public virtual sf::Drawable {
+class SokobanPlayer : public virtual sf::Drawable, public virtual SokobanGame {
  public:
     /**
-     * @brief Returns the players' current position; (0, 0) represents the upper-left cell in the
-     * upper-left corner.
+     * @brief Sets the fraction of a step elapsed since the last step, from 0 to 1; the player is
+     * drawn at that fraction of the way from the position of the step before to that of the last
+     * step. It is 1 by default, which draws the player where it is.
      */
-    [[nodiscard]] sf::Vector2u playerLoc() const;
+    void setInterpolation(float interpolation);
 
  protected:
     /**
-     * @brief Creates a SokobanPlayer instance; initalizes the player texture map and the player
-     * sprite map.
+     * @brief Creates a SokobanPlayer instance.
+     * @param atlas The texture atlas that contains the player sprites.
      */
-    SokobanPlayer();
+    explicit SokobanPlayer(std::shared_ptr<const SokobanAtlas> atlas);
 
     /**
      * @brief Draws the player onto the target.
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
+    /**
+     * @brief Records the position of the player at the end of a step; it should be called at the
+     * end of each update.
+     */
+    void recordStep();
 
     /**
-     * @brief The player's default orientation.
+     * @brief Returns the position of the player to draw in tiles. A move between two steps is
+     * interpolated; a jump (a reset or a new level) is not.
      */
-    inline static Direction DEFAULT_ORIENTATION = Direction::Down;
+    [[nodiscard]] sf::Vector2f playerPosition() const;
 
     /**
-     * @brief Player location. Note the unit of this coordinate is tile instead of pixel.
+     * @brief The texture atlas that contains the player sprites, which vary depending on the
+     * orientation.
      */
-    sf::Vector2i m_playerLoc = { 0, 0 };
+    std::shared_ptr<const SokobanAtlas> m_playerAtlas;
 
+ private:
     /**
-     * @brief Associates each direction with the corresponding player texture.
+     * @brief The fraction of a step elapsed since the last step.
      */
-    std::unordered_map<Direction, std::shared_ptr<sf::Texture>> m_playerTextureMap;
+    float m_interpolation = 1.0f;
 
     /**
-     * @brief Associates each direction with the corresponding player sprite. Player sprites vary
-     * depending on the orientation.
+     * @brief The location of the player at the end of the step before the last step.
      */
-    std::unordered_map<Direction, std::shared_ptr<sf::Sprite>> m_playerSpriteMap;
+    sf::Vector2i m_previousStepPlayerLoc;
 
     /**
-     * @brief Player's current orientation. The default orientation is down.
+     * @brief The location of the player at the end of the last step.
      */
-    Direction m_playerOrientation = DEFAULT_ORIENTATION;
+    sf::Vector2i m_lastStepPlayerLoc;
 };
 
 }  // namespace SB
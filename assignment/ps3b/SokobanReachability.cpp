@@ -0,0 +1,63 @@
+// Copyright 2024 James Chen
+
+#include "SokobanReachability.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace SB {
+
+int SokobanReachability::compute(const SokobanState& state) {
+    const auto& board = state.board();
+    const auto size = static_cast<std::size_t>(board.size());
+    if (m_stamps.size() != size) {
+        m_stamps.assign(size, 0);
+        m_generation = 0;
+    }
+
+    // Start a new generation; the stamps are only cleared when the generation wraps around
+    if (++m_generation == 0) {
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_generation = 1;
+    }
+
+    // The region is also the queue: the tiles before the head have been expanded
+    const auto playerIndex = state.playerIndex();
+    m_region.clear();
+    m_region.push_back(playerIndex);
+    m_stamps[playerIndex] = m_generation;
+    m_canonicalPlayerIndex = playerIndex;
+    for (std::size_t head = 0; head < m_region.size(); ++head) {
+        const auto index = m_region[head];
+        for (const auto direction : DIRECTIONS) {
+            const auto next = board.neighbor(index, direction);
+            if (next < 0 || m_stamps[next] == m_generation || board.isWall(next) ||
+                state.hasBox(next)) {
+                continue;
+            }
+
+            m_stamps[next] = m_generation;
+            m_region.push_back(next);
+            m_canonicalPlayerIndex = std::min(m_canonicalPlayerIndex, next);
+        }
+    }
+
+    return m_canonicalPlayerIndex;
+}
+
+bool SokobanReachability::isReachable(const int index) const {
+    return index >= 0 && static_cast<std::size_t>(index) < m_stamps.size() &&
+           m_stamps[index] == m_generation;
+}
+
+const std::vector<int>& SokobanReachability::region() const { return m_region; }
+
+int SokobanReachability::canonicalPlayerIndex() const { return m_canonicalPlayerIndex; }
+
+SokobanState SokobanReachability::normalize(const SokobanState& state) {
+    auto normalized = state;
+    normalized.movePlayer(compute(state));
+
+    return normalized;
+}
+
+}  // namespace SB
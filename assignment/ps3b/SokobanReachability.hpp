@@ -0,0 +1,75 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANREACHABILITY_HPP
+#define SOKOBANREACHABILITY_HPP
+
+#include <cstdint>
+#include <vector>
+#include "SokobanState.hpp"
+
+namespace SB {
+
+/**
+ * @brief This class finds the region that the player can reach without pushing a box. It is meant
+ * to be reused: the visited marks are stamped with a generation number that is bumped on each
+ * call, so they are never cleared, and the region doubles as the queue of the breadth-first
+ * search, so nothing is allocated once the buffers have grown to the size of the level.
+ */
+class SokobanReachability {
+ public:
+    /**
+     * @brief Finds the region that the player of a state can reach without pushing a box.
+     * @param state The state to analyze.
+     * @return The canonical player index: the top-left reachable tile.
+     */
+    int compute(const SokobanState& state);
+
+    /**
+     * @brief Returns whether the tile at a specified index was reached in the last computation. It
+     * returns false before the first computation and for an index outside the level.
+     */
+    [[nodiscard]] bool isReachable(int index) const;
+
+    /**
+     * @brief Returns the indices of the reachable tiles of the last computation, in breadth-first
+     * order from the player.
+     */
+    [[nodiscard]] const std::vector<int>& region() const;
+
+    /**
+     * @brief Returns the smallest reachable index of the last computation, which is the top-left
+     * reachable tile. The states that differ only by the player location within the region share
+     * it, so they hash the same once the player is moved there.
+     */
+    [[nodiscard]] int canonicalPlayerIndex() const;
+
+    /**
+     * @brief Returns a copy of a state whose player is moved to the canonical player index.
+     */
+    [[nodiscard]] SokobanState normalize(const SokobanState& state);
+
+ private:
+    /**
+     * @brief The generation in which each tile was last reached.
+     */
+    std::vector<uint32_t> m_stamps;
+
+    /**
+     * @brief The generation of the last computation; a tile is reachable if its stamp equals it.
+     */
+    uint32_t m_generation = 0;
+
+    /**
+     * @brief The reachable tiles of the last computation.
+     */
+    std::vector<int> m_region;
+
+    /**
+     * @brief The smallest reachable index of the last computation.
+     */
+    int m_canonicalPlayerIndex = -1;
+};
+
+}  // namespace SB
+
+#endif
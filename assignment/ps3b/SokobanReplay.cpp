@@ -0,0 +1,153 @@
+// Copyright 2024 James Chen
+
+#include "SokobanReplay.hpp"
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "SokobanGame.hpp"
+
+namespace SB {
+
+/**
+ * @brief The bit that marks the header of a run.
+ */
+constexpr uint8_t RUN_HEADER_FLAG = 0x80;
+
+SokobanReplay::SokobanReplay(const std::vector<Direction>& moves) : m_moveCount(moves.size()) {
+    const auto moveCount = moves.size();
+    std::size_t i = 0;
+    while (i < moveCount) {
+        const auto headRunLength = runLength(moves, i);
+        if (headRunLength >= MIN_RUN_LENGTH) {
+            m_data.push_back(static_cast<uint8_t>(
+                RUN_HEADER_FLAG | static_cast<int>(moves[i]) << 5 | (headRunLength - 1)));
+            i += headRunLength;
+            continue;
+        }
+
+        // Collect the literal moves until the next run that is long enough, and pack them
+        auto literalCount = std::size_t{ 0 };
+        while (i + literalCount < moveCount && literalCount < MAX_LITERAL_COUNT &&
+               (literalCount == 0 || runLength(moves, i + literalCount) < MIN_RUN_LENGTH)) {
+            ++literalCount;
+        }
+        m_data.push_back(static_cast<uint8_t>(literalCount - 1));
+        for (std::size_t j = 0; j < literalCount; j += MOVES_PER_BYTE) {
+            uint8_t packedMoves = 0;
+            for (std::size_t k = 0; k < MOVES_PER_BYTE; ++k) {
+                const auto code = j + k < literalCount ? static_cast<int>(moves[i + j + k]) : 0;
+                packedMoves = static_cast<uint8_t>(packedMoves << 2 | code);
+            }
+            m_data.push_back(packedMoves);
+        }
+        i += literalCount;
+    }
+}
+
+std::size_t SokobanReplay::moveCount() const { return m_moveCount; }
+
+const std::vector<uint8_t>& SokobanReplay::data() const { return m_data; }
+
+std::vector<Direction> SokobanReplay::moves() const {
+    std::vector<Direction> moves;
+    moves.reserve(m_moveCount);
+    forEachMove([&moves](const Direction direction) { moves.push_back(direction); });
+
+    return moves;
+}
+
+void SokobanReplay::forEachMove(const std::function<void(Direction)>& callback) const {
+    const auto size = m_data.size();
+    for (std::size_t i = 0; i < size;) {
+        const auto header = m_data[i++];
+        if (header & RUN_HEADER_FLAG) {
+            const auto direction = static_cast<Direction>(header >> 5 & 0b11);
+            const auto runLength = (header & 0b11111) + 1;
+            for (int j = 0; j < runLength; ++j) {
+                callback(direction);
+            }
+            continue;
+        }
+
+        const auto literalCount = std::size_t{ header } + 1;
+        for (std::size_t j = 0; j < literalCount; ++j) {
+            const auto shift = 2 * (MOVES_PER_BYTE - 1 - j % MOVES_PER_BYTE);
+            callback(static_cast<Direction>(m_data[i + j / MOVES_PER_BYTE] >> shift & 0b11));
+        }
+        i += (literalCount + MOVES_PER_BYTE - 1) / MOVES_PER_BYTE;
+    }
+}
+
+std::size_t SokobanReplay::runLength(const std::vector<Direction>& moves, const std::size_t i) {
+    auto length = std::size_t{ 1 };
+    while (i + length < moves.size() && length < MAX_RUN_LENGTH && moves[i + length] == moves[i]) {
+        ++length;
+    }
+
+    return length;
+}
+
+bool SokobanReplay::verify(const SokobanGame& game) const {
+    auto copy = game;
+    forEachMove([&copy](const Direction direction) { copy.movePlayer(direction); });
+
+    return copy.isWon();
+}
+
+std::ifstream& operator>>(std::ifstream& ifstream, SokobanReplay& replay) {
+    // Check the magic number
+    std::string magic(SokobanReplay::MAGIC.size(), '\0');
+    ifstream.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if (!ifstream || magic != SokobanReplay::MAGIC) {
+        throw std::invalid_argument("Not a replay file.");
+    }
+
+    // Read the number of moves in little endian
+    uint8_t moveCountBytes[4]{};
+    ifstream.read(reinterpret_cast<char*>(moveCountBytes), sizeof(moveCountBytes));
+    if (!ifstream) {
+        throw std::invalid_argument("The replay file is truncated.");
+    }
+    replay.m_moveCount = 0;
+    for (int i = 3; i >= 0; --i) {
+        replay.m_moveCount = replay.m_moveCount << 8 | moveCountBytes[i];
+    }
+
+    // The blocks take the rest of the file; count the moves to make sure that they are intact
+    replay.m_data.assign(std::istreambuf_iterator<char>(ifstream), {});
+    const auto size = replay.m_data.size();
+    std::size_t decodedMoveCount = 0;
+    for (std::size_t i = 0; i < size;) {
+        const auto header = replay.m_data[i++];
+        if (header & RUN_HEADER_FLAG) {
+            decodedMoveCount += (header & 0b11111) + 1;
+            continue;
+        }
+
+        const auto literalCount = std::size_t{ header } + 1;
+        i += (literalCount + SokobanReplay::MOVES_PER_BYTE - 1) / SokobanReplay::MOVES_PER_BYTE;
+        if (i > size) {
+            throw std::invalid_argument("The replay file contains a truncated block.");
+        }
+        decodedMoveCount += literalCount;
+    }
+    if (decodedMoveCount != replay.m_moveCount) {
+        throw std::invalid_argument("The number of moves in the replay file does not match.");
+    }
+
+    return ifstream;
+}
+
+std::ofstream& operator<<(std::ofstream& ofstream, const SokobanReplay& replay) {
+    ofstream << SokobanReplay::MAGIC;
+    for (int i = 0; i < 4; ++i) {
+        ofstream.put(static_cast<char>(replay.m_moveCount >> (8 * i) & 0xFF));
+    }
+    ofstream.write(reinterpret_cast<const char*>(replay.m_data.data()),
+                   static_cast<std::streamsize>(replay.m_data.size()));
+
+    return ofstream;
+}
+
+}  // namespace SB
@@ -0,0 +1,129 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANREPLAY_HPP
+#define SOKOBANREPLAY_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "SokobanConstants.hpp"
+
+namespace SB {
+
+class SokobanGame;
+
+/**
+ * @brief This class stores the moves of a player in a compact form, so that solutions can be saved
+ * and verified later. Each move is a two-bit direction code, and the moves are encoded into a
+ * sequence of blocks, each of which starts with a one-byte header:
+ *   1ddnnnnn  A run of n + 1 (1 to 32) moves in the direction d.
+ *   0nnnnnnn  n + 1 (1 to 128) literal moves, packed four per byte in the following bytes; the
+ *             first move takes the two highest bits, and the unused bits of the last byte are 0.
+ * Runs of eight or more moves are encoded as runs, and the other moves are literal, so a literal
+ * move takes 2 bits and a header is shared by up to 128 of them.
+ */
+class SokobanReplay {
+ public:
+    /**
+     * @brief The magic number at the beginning of a replay file.
+     */
+    inline static const std::string MAGIC = "SBR2";
+
+    /**
+     * @brief Creates an empty replay.
+     */
+    SokobanReplay() = default;
+
+    /**
+     * @brief Creates a replay of a specified sequence of moves.
+     * @param moves The directions in which the player moves.
+     */
+    explicit SokobanReplay(const std::vector<Direction>& moves);
+
+    /**
+     * @brief Returns the number of moves in this replay.
+     */
+    [[nodiscard]] std::size_t moveCount() const;
+
+    /**
+     * @brief Returns the encoded blocks.
+     */
+    [[nodiscard]] const std::vector<uint8_t>& data() const;
+
+    /**
+     * @brief Decodes and returns the moves in this replay.
+     */
+    [[nodiscard]] std::vector<Direction> moves() const;
+
+    /**
+     * @brief Invokes a specified callback function for each move without decoding the whole replay.
+     * @param callback The callback function to be invoked for each move in order.
+     */
+    void forEachMove(const std::function<void(Direction)>& callback) const;
+
+    /**
+     * @brief Replays the moves on a copy of a specified game without rendering, and returns whether
+     * the copy is won. The specified game is unchanged, so it can be reused to verify many replays
+     * of the same level.
+     * @param game The game in the initial state of a level.
+     */
+    [[nodiscard]] bool verify(const SokobanGame& game) const;
+
+    /**
+     * @brief Reads a replay from a replay file, which should be opened in binary mode.
+     * @throws std::invalid_argument if the file is not a valid replay file.
+     */
+    friend std::ifstream& operator>>(std::ifstream& ifstream, SokobanReplay& replay);
+
+    /**
+     * @brief Writes a replay to a replay file, which should be opened in binary mode. The file
+     * consists of the magic number, the number of moves in four bytes (little endian) and the
+     * blocks.
+     */
+    friend std::ofstream& operator<<(std::ofstream& ofstream, const SokobanReplay& replay);
+
+ private:
+    /**
+     * @brief The maximum number of moves in a run.
+     */
+    static constexpr std::size_t MAX_RUN_LENGTH = 32;
+
+    /**
+     * @brief The minimum number of moves in the same direction to be encoded as a run. A shorter
+     * run takes no more bytes as literal moves than a run header and the header of the literal
+     * block after it.
+     */
+    static constexpr std::size_t MIN_RUN_LENGTH = 8;
+
+    /**
+     * @brief The maximum number of moves in a literal block.
+     */
+    static constexpr std::size_t MAX_LITERAL_COUNT = 128;
+
+    /**
+     * @brief The number of moves packed in a byte of a literal block.
+     */
+    static constexpr std::size_t MOVES_PER_BYTE = 4;
+
+    /**
+     * @brief Returns the number of moves in the same direction from a specified move, up to
+     * MAX_RUN_LENGTH.
+     */
+    [[nodiscard]] static std::size_t runLength(const std::vector<Direction>& moves, std::size_t i);
+
+    /**
+     * @brief The number of moves in this replay.
+     */
+    std::size_t m_moveCount = 0;
+
+    /**
+     * @brief The encoded blocks.
+     */
+    std::vector<uint8_t> m_data;
+};
+
+}  // namespace SB
+
+#endif
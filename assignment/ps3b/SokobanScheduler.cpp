@@ -0,0 +1,85 @@
+// Copyright 2024 James Chen
+
+#include "SokobanScheduler.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Applies a command to a game.
+ */
+void apply_command(SB::SokobanGame& game, const SB::Command& command) {
+    switch (command.type) {
+        case SB::CommandType::Move:
+            game.movePlayer(command.direction);
+            break;
+        case SB::CommandType::Undo:
+            game.undo();
+            break;
+        case SB::CommandType::Redo:
+            game.redo();
+            break;
+        case SB::CommandType::Reset:
+            game.reset();
+            break;
+    }
+}
+
+}  // namespace
+
+namespace SB {
+
+SokobanScheduler::SokobanScheduler(const int64_t stepTimeInMicroseconds) :
+    m_stepTime(stepTimeInMicroseconds) {
+    if (stepTimeInMicroseconds <= 0) {
+        throw std::invalid_argument("The step time must be positive.");
+    }
+}
+
+void SokobanScheduler::push(const Command& command) { m_commands.push_back(command); }
+
+void SokobanScheduler::clear() { m_commands.clear(); }
+
+std::size_t SokobanScheduler::pendingCommandCount() const { return m_commands.size(); }
+
+int SokobanScheduler::advance(SokobanGame& game, const int64_t elapsedTimeInMicroseconds) {
+    m_accumulatedTime += std::max<int64_t>(elapsedTimeInMicroseconds, 0);
+    auto stepCount = 0;
+    while (m_accumulatedTime >= m_stepTime && stepCount < MAX_STEPS_PER_FRAME) {
+        m_accumulatedTime -= m_stepTime;
+        step(game);
+        ++stepCount;
+    }
+
+    // Drop the time that the steps of this frame could not catch up with
+    m_accumulatedTime = std::min(m_accumulatedTime, m_stepTime - 1);
+
+    return stepCount;
+}
+
+void SokobanScheduler::runSteps(SokobanGame& game, const int stepCount) {
+    for (int i = 0; i < stepCount; ++i) {
+        step(game);
+    }
+}
+
+float SokobanScheduler::interpolation() const {
+    return static_cast<float>(m_accumulatedTime) / static_cast<float>(m_stepTime);
+}
+
+int64_t SokobanScheduler::stepTime() const { return m_stepTime; }
+
+uint64_t SokobanScheduler::stepCount() const { return m_stepCount; }
+
+void SokobanScheduler::step(SokobanGame& game) {
+    while (!m_commands.empty()) {
+        apply_command(game, m_commands.front());
+        m_commands.pop_front();
+    }
+
+    game.update(m_stepTime);
+    ++m_stepCount;
+}
+
+}  // namespace SB
@@ -0,0 +1,131 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANSCHEDULER_HPP
+#define SOKOBANSCHEDULER_HPP
+
+#include <cstdint>
+#include <deque>
+#include "SokobanConstants.hpp"
+#include "SokobanGame.hpp"
+
+namespace SB {
+
+/**
+ * @brief Enumerates the commands that the player can give to a game.
+ */
+enum class CommandType { Move, Undo, Redo, Reset };
+
+/**
+ * @brief A command of the player; the direction is only meaningful for a move.
+ */
+struct Command {
+    CommandType type;
+    Direction direction = Direction::Up;
+};
+
+/**
+ * @brief This class runs the logic of a game in fixed time steps, independent of the frame rate.
+ * The input is queued when it arrives, and the queued commands are applied in order at the
+ * beginning of the next step, so no keystroke is lost when a frame takes long to render. A frame
+ * runs as many steps as the elapsed time covers, and the time left over is the interpolation
+ * factor for rendering between the last two steps. Without a window, steps can be run directly,
+ * which is much faster than real time.
+ */
+class SokobanScheduler {
+ public:
+    /**
+     * @brief The default time of a step in microseconds, which is 120 steps per second.
+     */
+    static constexpr int64_t DEFAULT_STEP_TIME_IN_MICROSECONDS = 1000000 / 120;
+
+    /**
+     * @brief The maximum number of steps that a frame runs. After a long stall (a dragged window
+     * or a breakpoint), the time beyond these steps is dropped instead of being caught up, so
+     * that a slow frame cannot make the next frame even slower.
+     */
+    static constexpr int MAX_STEPS_PER_FRAME = 8;
+
+    /**
+     * @brief Creates a scheduler.
+     * @param stepTimeInMicroseconds The time of a step in microseconds.
+     * @throws std::invalid_argument if the step time is not positive.
+     */
+    explicit SokobanScheduler(int64_t stepTimeInMicroseconds = DEFAULT_STEP_TIME_IN_MICROSECONDS);
+
+    /**
+     * @brief Queues a command; it is applied at the beginning of the next step.
+     */
+    void push(const Command& command);
+
+    /**
+     * @brief Drops the queued commands that have not been applied.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of queued commands.
+     */
+    [[nodiscard]] std::size_t pendingCommandCount() const;
+
+    /**
+     * @brief Adds the elapsed time of a frame, and runs the steps that the accumulated time covers.
+     * @param game The game to run.
+     * @param elapsedTimeInMicroseconds The time elapsed since the previous frame.
+     * @return The number of steps run.
+     */
+    int advance(SokobanGame& game, int64_t elapsedTimeInMicroseconds);
+
+    /**
+     * @brief Runs a number of steps right away, regardless of the accumulated time.
+     * @param game The game to run.
+     * @param stepCount The number of steps to run.
+     */
+    void runSteps(SokobanGame& game, int stepCount);
+
+    /**
+     * @brief Returns the fraction of a step that the accumulated time covers, from 0 to 1; the
+     * rendering is interpolated by it between the last two steps.
+     */
+    [[nodiscard]] float interpolation() const;
+
+    /**
+     * @brief Returns the time of a step in microseconds.
+     */
+    [[nodiscard]] int64_t stepTime() const;
+
+    /**
+     * @brief Returns the number of steps run.
+     */
+    [[nodiscard]] uint64_t stepCount() const;
+
+ private:
+    /**
+     * @brief Runs a step: applies the queued commands, then updates the game by a step time.
+     */
+    void step(SokobanGame& game);
+
+    /**
+     * @brief The time of a step in microseconds.
+     */
+    int64_t m_stepTime;
+
+    /**
+     * @brief The accumulated time that has not been run yet, which is less than a step time after
+     * each frame.
+     */
+    int64_t m_accumulatedTime = 0;
+
+    /**
+     * @brief The number of steps run.
+     */
+    uint64_t m_stepCount = 0;
+
+    /**
+     * @brief The commands that have not been applied, in the order they arrived.
+     */
+    std::deque<Command> m_commands;
+};
+
+}  // namespace SB
+
+#endif
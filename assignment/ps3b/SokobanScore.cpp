@@ -2,24 +2,26 @@
 
 #include "SokobanScore.hpp"
 #include <string>
+#include "FrameProfiler.hpp"
+#include "ResourceCache.hpp"
 #include "SokobanConstants.hpp"
 
 namespace SB {
 
-SokobanScore::SokobanScore() { m_font.loadFromFile(FONT_DIGITAL7_FILENAME); }
-
-bool SokobanScore::isWon() const { return m_score == m_maxScore; }
+SokobanScore::SokobanScore() :
+    m_font(RC::ResourceCache::shared().font(FONT_DIGITAL7_FILENAME)) {}
 
 void SokobanScore::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     const std::string stringToPrint = std::to_string(m_score) + "/" + std::to_string(m_maxScore);
 
     sf::Text text;
-    text.setFont(m_font);
+    text.setFont(*m_font);
     text.setString(stringToPrint);
     text.setCharacterSize(28);
     text.setFillColor(isWon() ? sf::Color::Green : sf::Color::Red);
     text.setPosition(target.getSize().x - 60, 10);
     target.draw(text);
+    FP::countDrawCall();
 }
 
 }  // namespace SB
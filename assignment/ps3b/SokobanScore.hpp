@@ -3,48 +3,32 @@
 #ifndef SOKOBANSCORE_HPP
 #define SOKOBANSCORE_HPP
 
+#include <memory>
 #include <SFML/Graphics.hpp>
+#include "SokobanGame.hpp"
 
 namespace SB {
 
 /**
- * @brief This class manages the score system in Sokoban.
+ * @brief This class draws the score of a game.
  */
-class SokobanScore : public virtual sf::Drawable {
+class SokobanScore : public virtual sf::Drawable, public virtual SokobanGame {
  public:
     /**
      * @brief Creates a SokobanScore instance; initializes the font.
      */
     SokobanScore();
 
-    /**
-     * @brief Checks if the player has won the game.
-     * @return True if the player has won the game; false otherwise.
-     */
-    bool isWon() const;
-
  protected:
     /**
      * @brief Draws the score and the max score onto the target.
      */
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
-    /**
-     * @brief The player's current score. Players get one score when they successfully put a box to
-     * a storage. In a word, the score is equals to the number of "StorageBox" block in the map.
-     */
-    int m_score = 0;
-
-    /**
-     * @brief The player's max score in the current level. The player wins the game when the score
-     * equals the max score.
-     */
-    int m_maxScore = 1;
-
     /**
      * @brief The font for the diplayed text.
      */
-    sf::Font m_font;
+    std::shared_ptr<const sf::Font> m_font;
 };
 
 }  // namespace SB
@@ -0,0 +1,617 @@
+// Copyright 2024 James Chen
+
+#include "SokobanSolver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Solves the rectangular assignment problem with the Hungarian algorithm.
+ * @param cost The cost matrix; it must have no more rows than columns.
+ * @return The minimum total cost of assigning every row to a distinct column.
+ */
+int min_cost_assignment(const std::vector<std::vector<int>>& cost) {
+    const auto rows = static_cast<int>(cost.size());
+    if (rows == 0) {
+        return 0;
+    }
+
+    // Potentials and matching are 1-indexed; column 0 is a virtual column
+    const auto cols = static_cast<int>(cost[0].size());
+    constexpr auto INF = std::numeric_limits<int>::max() / 2;
+    std::vector<int> u(rows + 1, 0);
+    std::vector<int> v(cols + 1, 0);
+    std::vector<int> match(cols + 1, 0);
+    std::vector<int> way(cols + 1, 0);
+    for (int row = 1; row <= rows; ++row) {
+        match[0] = row;
+        auto col0 = 0;
+        std::vector<int> minv(cols + 1, INF);
+        std::vector<bool> used(cols + 1, false);
+        do {
+            used[col0] = true;
+            const auto row0 = match[col0];
+            auto delta = INF;
+            auto col1 = 0;
+            for (int col = 1; col <= cols; ++col) {
+                if (used[col]) {
+                    continue;
+                }
+
+                const auto reduced = cost[row0 - 1][col - 1] - u[row0] - v[col];
+                if (reduced < minv[col]) {
+                    minv[col] = reduced;
+                    way[col] = col0;
+                }
+                if (minv[col] < delta) {
+                    delta = minv[col];
+                    col1 = col;
+                }
+            }
+
+            for (int col = 0; col <= cols; ++col) {
+                if (used[col]) {
+                    u[match[col]] += delta;
+                    v[col] -= delta;
+                } else {
+                    minv[col] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (match[col0] != 0);
+
+        // Augment along the alternating path
+        do {
+            const auto col1 = way[col0];
+            match[col0] = match[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
+
+    auto total = 0;
+    for (int col = 1; col <= cols; ++col) {
+        if (match[col] != 0) {
+            total += cost[match[col] - 1][col - 1];
+        }
+    }
+
+    return total;
+}
+
+}  // namespace
+
+namespace SB {
+
+/**
+ * @brief A node in the search tree.
+ */
+struct SearchNode {
+    SokobanState state;
+    int parent;
+    Push push;
+    int pushes;
+};
+
+/**
+ * @brief A state sent to the worker that owns it in a parallel search.
+ */
+struct SearchMessage {
+    SokobanState state;
+    int pushes;
+    int bound;
+    uint64_t parentHash;
+    Push push;
+};
+
+/**
+ * @brief The best known path to a state in a parallel search. The path is followed through the
+ * parent hashes; the root has no push.
+ */
+struct SearchRecord {
+    int pushes;
+    uint64_t parentHash;
+    Push push;
+};
+
+/**
+ * @brief A worker of a parallel search. A worker owns the states whose hashes are congruent to its
+ * index modulo the number of workers: only the owner queues and records them, so the open lists
+ * and the transposition tables are never shared. Other workers send states through the inbox.
+ */
+struct SearchWorker {
+    std::mutex inboxMutex;
+    std::vector<SearchMessage> inbox;
+    std::vector<SearchMessage> nodes;
+    std::priority_queue<std::tuple<int, int, int>, std::vector<std::tuple<int, int, int>>,
+                        std::greater<>>
+        openList;
+    std::unordered_map<uint64_t, SearchRecord> transpositionTable;
+    SolverStatistics statistics;
+};
+
+SokobanSolver::SokobanSolver(const SokobanState& initialState) :
+    SokobanSolver(
+        initialState, std::make_shared<const SokobanLevelAnalysis>(initialState.board())) {}
+
+SokobanSolver::SokobanSolver(
+    const SokobanState& initialState, std::shared_ptr<const SokobanLevelAnalysis> analysis) :
+    m_initialState(initialState),
+    m_analysis(std::move(analysis)),
+    m_storages(m_analysis->storages()),
+    m_boxCount(initialState.boxes().count()) {}
+
+Solution SokobanSolver::solve(const uint64_t maxNodes) const {
+    const auto startTime = std::chrono::steady_clock::now();
+    Solution solution;
+    auto& statistics = solution.statistics;
+
+    // The open list is ordered by f = g + h; ties are broken by the smaller h
+    using OpenEntry = std::tuple<int, int, int>;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<>> openList;
+
+    // The transposition table maps the Zobrist hash of a state to its fewest pushes found so far
+    std::unordered_map<uint64_t, int> transpositionTable;
+    std::vector<SearchNode> nodes;
+
+    SokobanReachability reachability;
+    SokobanReachability childReachability;
+    const auto root = reachability.normalize(m_initialState);
+    const auto rootBound = lowerBound(root);
+    if (rootBound < UNSOLVABLE) {
+        nodes.push_back({ root, -1, { -1, Direction::Up }, 0 });
+        transpositionTable[root.hash()] = 0;
+        openList.emplace(rootBound, rootBound, 0);
+    }
+
+    auto goalNode = -1;
+    while (!openList.empty() && statistics.expandedNodes < maxNodes) {
+        const auto nodeIndex = std::get<2>(openList.top());
+        openList.pop();
+
+        // Skip the entry if a shorter path to the state has been found after it was queued
+        const auto state = nodes[nodeIndex].state;
+        const auto pushes = nodes[nodeIndex].pushes;
+        if (transpositionTable.at(state.hash()) < pushes) {
+            continue;
+        }
+
+        if (isSolved(state)) {
+            goalNode = nodeIndex;
+            break;
+        }
+
+        ++statistics.expandedNodes;
+        const auto onChild = [&](const SokobanState& child, const Push& push) {
+            const auto childPushes = pushes + 1;
+            const auto it = transpositionTable.find(child.hash());
+            if (it != transpositionTable.end() && it->second <= childPushes) {
+                ++statistics.duplicateNodes;
+                return;
+            }
+
+            const auto childBound = lowerBound(child);
+            if (childBound >= UNSOLVABLE) {
+                ++statistics.deadlockNodes;
+                return;
+            }
+
+            transpositionTable[child.hash()] = childPushes;
+            nodes.push_back({ child, nodeIndex, push, childPushes });
+            openList.emplace(
+                childPushes + childBound, childBound, static_cast<int>(nodes.size()) - 1);
+        };
+        expand(state, reachability, childReachability, statistics, onChild);
+    }
+
+    if (goalNode >= 0) {
+        solution.isSolved = true;
+        for (auto i = goalNode; nodes[i].parent >= 0; i = nodes[i].parent) {
+            solution.pushes.push_back(nodes[i].push);
+        }
+        std::reverse(solution.pushes.begin(), solution.pushes.end());
+        completeMoves(solution);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - startTime;
+    statistics.elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+
+    return solution;
+}
+
+Solution SokobanSolver::solveParallel(const int threadCount, const uint64_t maxNodes) const {
+    if (threadCount < 1) {
+        throw std::invalid_argument("The number of threads must be positive.");
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto workerCount = static_cast<uint64_t>(threadCount);
+    std::vector<SearchWorker> workers(workerCount);
+
+    // The number of states that are queued or in an inbox; the search ends when it drops to zero
+    std::atomic<int64_t> pendingCount{ 0 };
+    std::atomic<uint64_t> expandedCount{ 0 };
+    std::atomic<bool> isStopped{ false };
+    std::atomic<int> bestPushes{ UNSOLVABLE };
+    std::mutex goalMutex;
+    uint64_t goalHash = 0;
+
+    // Sends the buffered states to their owners; each inbox is locked once
+    const auto flush = [&](std::vector<std::vector<SearchMessage>>& outboxes) {
+        for (uint64_t i = 0; i < workerCount; ++i) {
+            if (outboxes[i].empty()) {
+                continue;
+            }
+
+            const std::lock_guard<std::mutex> lock{ workers[i].inboxMutex };
+            auto& inbox = workers[i].inbox;
+            std::move(outboxes[i].begin(), outboxes[i].end(), std::back_inserter(inbox));
+            outboxes[i].clear();
+        }
+    };
+
+    const auto root = SokobanReachability{}.normalize(m_initialState);
+    const auto rootBound = lowerBound(root);
+    if (rootBound < UNSOLVABLE) {
+        pendingCount = 1;
+        workers[root.hash() % workerCount].inbox.push_back(
+            { root, 0, rootBound, 0, { -1, Direction::Up } });
+    }
+
+    const auto work = [&](SearchWorker& worker) {
+        auto& statistics = worker.statistics;
+        std::vector<SearchMessage> received;
+        std::vector<std::vector<SearchMessage>> outboxes(workerCount);
+        SokobanReachability reachability;
+        SokobanReachability childReachability;
+        while (!isStopped) {
+            {
+                const std::lock_guard<std::mutex> lock{ worker.inboxMutex };
+                received.swap(worker.inbox);
+            }
+
+            // Queue the received states that are new or reached with fewer pushes
+            int64_t duplicateCount = 0;
+            for (auto& message : received) {
+                const auto hash = message.state.hash();
+                const auto it = worker.transpositionTable.find(hash);
+                if (it != worker.transpositionTable.end() && it->second.pushes <= message.pushes) {
+                    ++duplicateCount;
+                    continue;
+                }
+
+                worker.transpositionTable[hash] = { message.pushes, message.parentHash,
+                                                    message.push };
+                worker.openList.emplace(
+                    message.pushes + message.bound, message.bound,
+                    static_cast<int>(worker.nodes.size()));
+                worker.nodes.push_back(std::move(message));
+            }
+            received.clear();
+            statistics.duplicateNodes += duplicateCount;
+            pendingCount -= duplicateCount;
+
+            if (worker.openList.empty()) {
+                if (pendingCount == 0) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            const auto [f, h, nodeIndex] = worker.openList.top();
+            worker.openList.pop();
+            const auto state = worker.nodes[nodeIndex].state;
+            const auto pushes = worker.nodes[nodeIndex].pushes;
+
+            // Unlike the serial search, a goal found first may not be the best one, so states are
+            // expanded until none of them can lead to a better goal
+            if (worker.transpositionTable.at(state.hash()).pushes < pushes ||
+                f >= bestPushes) {
+                --pendingCount;
+                continue;
+            }
+
+            if (isSolved(state)) {
+                const std::lock_guard<std::mutex> lock{ goalMutex };
+                if (pushes < bestPushes) {
+                    bestPushes = pushes;
+                    goalHash = state.hash();
+                }
+                --pendingCount;
+                continue;
+            }
+
+            ++statistics.expandedNodes;
+            if (++expandedCount >= maxNodes) {
+                isStopped = true;
+            }
+
+            const auto parentHash = state.hash();
+            int64_t sentCount = 0;
+            const auto onChild = [&](const SokobanState& child, const Push& push) {
+                const auto childBound = lowerBound(child);
+                if (childBound >= UNSOLVABLE) {
+                    ++statistics.deadlockNodes;
+                    return;
+                }
+
+                if (pushes + 1 + childBound < bestPushes) {
+                    outboxes[child.hash() % workerCount].push_back(
+                        { child, pushes + 1, childBound, parentHash, push });
+                    ++sentCount;
+                }
+            };
+            expand(state, reachability, childReachability, statistics, onChild);
+
+            // The children are counted before the expanded state is uncounted and before they are
+            // delivered, so that the pending count never drops to zero while work remains
+            pendingCount += sentCount - 1;
+            flush(outboxes);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+    for (auto& worker : workers) {
+        threads.emplace_back(work, std::ref(worker));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Solution solution;
+    auto& statistics = solution.statistics;
+    for (const auto& worker : workers) {
+        statistics.expandedNodes += worker.statistics.expandedNodes;
+        statistics.generatedNodes += worker.statistics.generatedNodes;
+        statistics.duplicateNodes += worker.statistics.duplicateNodes;
+        statistics.deadlockNodes += worker.statistics.deadlockNodes;
+    }
+
+    if (bestPushes < UNSOLVABLE) {
+        // Follow the parent hashes through the tables of the owners back to the root
+        solution.isSolved = true;
+        for (auto hash = goalHash;;) {
+            const auto& record = workers[hash % workerCount].transpositionTable.at(hash);
+            if (record.push.boxIndex < 0) {
+                break;
+            }
+            solution.pushes.push_back(record.push);
+            hash = record.parentHash;
+        }
+        std::reverse(solution.pushes.begin(), solution.pushes.end());
+        completeMoves(solution);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - startTime;
+    statistics.elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+
+    return solution;
+}
+
+void SokobanSolver::expand(
+    const SokobanState& state,
+    SokobanReachability& reachability,
+    SokobanReachability& childReachability,
+    SolverStatistics& statistics,
+    const std::function<void(const SokobanState&, const Push&)>& callback) const {
+    // When there are more boxes than storages, an extra box may have to be parked on a dead square
+    const auto isDeadSquarePruned = m_boxCount <= static_cast<int>(m_storages.size());
+    reachability.compute(state);
+    state.boxes().forEach([&](const int boxIndex) {
+        for (const auto direction : DIRECTIONS) {
+            // The player must be able to stand behind the box
+            const auto playerIndex = neighbor(boxIndex, opposite(direction));
+            if (playerIndex < 0 || !reachability.isReachable(playerIndex)) {
+                continue;
+            }
+
+            // The box must be pushed to a live tile without a box
+            const auto toIndex = neighbor(boxIndex, direction);
+            if (toIndex < 0 || isBlocked(toIndex) || state.hasBox(toIndex) ||
+                (isDeadSquarePruned && m_analysis->isDeadSquare(toIndex))) {
+                continue;
+            }
+
+            ++statistics.generatedNodes;
+            auto child = state;
+            child.moveBox(boxIndex, toIndex);
+            child.movePlayer(boxIndex);
+            if (isFreezeDeadlock(child, toIndex)) {
+                ++statistics.deadlockNodes;
+                continue;
+            }
+
+            callback(childReachability.normalize(child), { boxIndex, direction });
+        }
+    });
+}
+
+void SokobanSolver::completeMoves(Solution& solution) const {
+    // Replay the pushes from the initial state to find the walks between them
+    auto state = m_initialState;
+    for (const auto& [boxIndex, direction] : solution.pushes) {
+        const auto playerIndex = neighbor(boxIndex, opposite(direction));
+        const auto walkStart = solution.moves.size();
+        appendWalk(state, state.playerIndex(), playerIndex, solution.moves);
+        for (auto i = walkStart; i < solution.moves.size(); ++i) {
+            solution.lurd.push_back(toLurd(solution.moves[i], false));
+        }
+        solution.moves.push_back(direction);
+        solution.lurd.push_back(toLurd(direction, true));
+        state.moveBox(boxIndex, neighbor(boxIndex, direction));
+        state.movePlayer(boxIndex);
+    }
+}
+
+int SokobanSolver::lowerBound(const SokobanState& state) const {
+    std::vector<int> boxes;
+    state.boxes().forEach([&](const int boxIndex) { boxes.push_back(boxIndex); });
+
+    // The smaller set is matched into the larger one; the extra boxes or storages are left out
+    const auto storageCount = static_cast<int>(m_storages.size());
+    const auto boxCount = static_cast<int>(boxes.size());
+    std::vector<std::vector<int>> cost;
+    if (boxCount <= storageCount) {
+        cost.assign(boxCount, std::vector<int>(storageCount));
+        for (int b = 0; b < boxCount; ++b) {
+            for (int s = 0; s < storageCount; ++s) {
+                cost[b][s] = m_analysis->distance(s, boxes[b]);
+            }
+        }
+    } else {
+        cost.assign(storageCount, std::vector<int>(boxCount));
+        for (int s = 0; s < storageCount; ++s) {
+            for (int b = 0; b < boxCount; ++b) {
+                cost[s][b] = m_analysis->distance(s, boxes[b]);
+            }
+        }
+    }
+
+    return std::min(min_cost_assignment(cost), UNSOLVABLE);
+}
+
+bool SokobanSolver::isDeadSquare(const int index) const {
+    return m_analysis->isDeadSquare(index);
+}
+
+bool SokobanSolver::isSolved(const SokobanState& state) const {
+    auto storedCount = 0;
+    for (const auto storage : m_storages) {
+        if (state.hasBox(storage)) {
+            ++storedCount;
+        }
+    }
+
+    return storedCount == std::min(m_boxCount, static_cast<int>(m_storages.size()));
+}
+
+char SokobanSolver::toLurd(const Direction direction, const bool isPush) {
+    char c = 'u';
+    switch (direction) {
+        case Direction::Up:
+            c = 'u';
+            break;
+        case Direction::Down:
+            c = 'd';
+            break;
+        case Direction::Left:
+            c = 'l';
+            break;
+        case Direction::Right:
+            c = 'r';
+            break;
+    }
+
+    return isPush ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+int SokobanSolver::neighbor(const int index, const Direction direction) const {
+    return m_initialState.board().neighbor(index, direction);
+}
+
+bool SokobanSolver::isBlocked(const int index) const {
+    return index < 0 || m_initialState.board().isWall(index);
+}
+
+bool SokobanSolver::isFreezeDeadlock(const SokobanState& state, const int boxIndex) const {
+    // When there are more boxes than storages, a frozen box may be one of the extra boxes
+    if (m_boxCount > static_cast<int>(m_storages.size())) {
+        return false;
+    }
+
+    std::unordered_set<int> frozenSet;
+    if (!isFrozen(state, boxIndex, frozenSet)) {
+        return false;
+    }
+
+    // A group of frozen boxes is a deadlock if any of them is off a storage
+    return std::any_of(frozenSet.begin(), frozenSet.end(), [&](const int index) {
+        return !state.board().isStorage(index);
+    });
+}
+
+bool SokobanSolver::isFrozen(
+    const SokobanState& state, const int boxIndex, std::unordered_set<int>& frozenSet) const {
+    frozenSet.insert(boxIndex);
+
+    // A neighbor blocks the box if it is a wall, or a box that is frozen itself
+    const auto isBlocking = [&](const int index) {
+        if (isBlocked(index) || frozenSet.count(index) > 0) {
+            return true;
+        }
+
+        return state.hasBox(index) && isFrozen(state, index, frozenSet);
+    };
+
+    // The box is stuck along an axis if either side blocks it, or both sides are dead squares
+    const auto isStuck = [&](const Direction first, const Direction second) {
+        const auto firstIndex = neighbor(boxIndex, first);
+        const auto secondIndex = neighbor(boxIndex, second);
+        if (isBlocked(firstIndex) || isBlocked(secondIndex)) {
+            return true;
+        }
+        if (m_analysis->isDeadSquare(firstIndex) && m_analysis->isDeadSquare(secondIndex)) {
+            return true;
+        }
+
+        return isBlocking(firstIndex) || isBlocking(secondIndex);
+    };
+
+    if (isStuck(Direction::Left, Direction::Right) && isStuck(Direction::Up, Direction::Down)) {
+        return true;
+    }
+
+    frozenSet.erase(boxIndex);
+
+    return false;
+}
+
+void SokobanSolver::appendWalk(
+    const SokobanState& state,
+    const int fromIndex,
+    const int toIndex,
+    std::vector<Direction>& moves) const {
+    // Breadth-first search from the start, remembering the direction that reaches each tile
+    std::vector<int> previous(state.board().size(), -1);
+    std::vector<Direction> via(state.board().size(), Direction::Up);
+    std::queue<int> queue;
+    previous[fromIndex] = fromIndex;
+    queue.push(fromIndex);
+    while (!queue.empty() && previous[toIndex] < 0) {
+        const auto index = queue.front();
+        queue.pop();
+        for (const auto direction : DIRECTIONS) {
+            const auto next = neighbor(index, direction);
+            if (isBlocked(next) || previous[next] >= 0 || state.hasBox(next)) {
+                continue;
+            }
+
+            previous[next] = index;
+            via[next] = direction;
+            queue.push(next);
+        }
+    }
+
+    std::vector<Direction> walk;
+    for (auto index = toIndex; index != fromIndex; index = previous[index]) {
+        walk.push_back(via[index]);
+    }
+    moves.insert(moves.end(), walk.rbegin(), walk.rend());
+}
+
+}  // namespace SB
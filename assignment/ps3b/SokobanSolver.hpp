@@ -0,0 +1,200 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANSOLVER_HPP
+#define SOKOBANSOLVER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "SokobanConstants.hpp"
+#include "SokobanLevelAnalysis.hpp"
+#include "SokobanReachability.hpp"
+#include "SokobanState.hpp"
+
+namespace SB {
+
+/**
+ * @brief A push: the box at a specified index is pushed one tile towards a specified direction.
+ */
+struct Push {
+    int boxIndex;
+    Direction direction;
+};
+
+/**
+ * @brief The statistics of a search.
+ */
+struct SolverStatistics {
+    uint64_t expandedNodes = 0;
+    uint64_t generatedNodes = 0;
+    uint64_t duplicateNodes = 0;
+    uint64_t deadlockNodes = 0;
+    double elapsedSeconds = 0.0;
+};
+
+/**
+ * @brief The result of a search. If the level is solved, the pushes and the complete move sequence
+ * (walks and pushes) are given. The moves are also given in LURD notation, where pushes are in
+ * upper case and walks are in lower case.
+ */
+struct Solution {
+    bool isSolved = false;
+    std::vector<Push> pushes;
+    std::vector<Direction> moves;
+    std::string lurd;
+    SolverStatistics statistics;
+};
+
+/**
+ * @brief This class solves a Sokoban level with A* over push-level states. Two states are the same
+ * if they have the same boxes and the player can walk from one player location to the other, so
+ * the player location is normalized to the top-left reachable tile. The lower bound is a
+ * minimum-cost matching between boxes and storages on the push distances; states with simple or
+ * freeze deadlocks are pruned.
+ */
+class SokobanSolver {
+ public:
+    /**
+     * @brief The default maximum number of nodes to expand.
+     */
+    static constexpr uint64_t DEFAULT_MAX_NODES = 2000000;
+
+    /**
+     * @brief The lower bound of a state that can never be solved.
+     */
+    static constexpr int UNSOLVABLE = SokobanLevelAnalysis::UNREACHABLE;
+
+    /**
+     * @brief Creates a solver for the level of a specified state; the level is analyzed.
+     * @param initialState The state to solve from.
+     */
+    explicit SokobanSolver(const SokobanState& initialState);
+
+    /**
+     * @brief Creates a solver for the level of a specified state with the analysis computed when
+     * the level was loaded.
+     * @param initialState The state to solve from.
+     * @param analysis The analysis of the level.
+     */
+    SokobanSolver(
+        const SokobanState& initialState, std::shared_ptr<const SokobanLevelAnalysis> analysis);
+
+    /**
+     * @brief Searches for the solution with the fewest pushes.
+     * @param maxNodes The maximum number of nodes to expand before giving up.
+     */
+    [[nodiscard]] Solution solve(uint64_t maxNodes = DEFAULT_MAX_NODES) const;
+
+    /**
+     * @brief Searches for the solution with the fewest pushes with several threads. Each state is
+     * owned by one thread, chosen by its hash; a thread expands the states it owns and sends the
+     * children to their owners, so no open list or transposition table is shared.
+     * @param threadCount The number of threads.
+     * @param maxNodes The maximum number of nodes to expand by all threads before giving up.
+     * @throws std::invalid_argument The number of threads is not positive.
+     */
+    [[nodiscard]] Solution
+    solveParallel(int threadCount, uint64_t maxNodes = DEFAULT_MAX_NODES) const;
+
+    /**
+     * @brief Returns the lower bound of the number of pushes to solve a state; returns UNSOLVABLE
+     * if the boxes cannot be matched to storages.
+     */
+    [[nodiscard]] int lowerBound(const SokobanState& state) const;
+
+    /**
+     * @brief Returns whether a box at a specified index can never reach any storage.
+     */
+    [[nodiscard]] bool isDeadSquare(int index) const;
+
+    /**
+     * @brief Returns whether a state is solved: as many boxes as possible are in storages.
+     */
+    [[nodiscard]] bool isSolved(const SokobanState& state) const;
+
+    /**
+     * @brief Converts a direction into a LURD character; pushes are in upper case and walks are in
+     * lower case.
+     */
+    [[nodiscard]] static char toLurd(Direction direction, bool isPush);
+
+ private:
+    /**
+     * @brief Returns the index of the neighbor of a tile towards a specified direction; returns -1
+     * if the neighbor is out of the map.
+     */
+    [[nodiscard]] int neighbor(int index, Direction direction) const;
+
+    /**
+     * @brief Returns whether the tile at a specified index is a wall or out of the map.
+     */
+    [[nodiscard]] bool isBlocked(int index) const;
+
+    /**
+     * @brief Generates the children of a state: the states after each push that neither moves a
+     * box to a dead square nor freezes it off a storage. The children are normalized.
+     * @param state The state to expand.
+     * @param reachability The reachability of the state to expand.
+     * @param childReachability The reachability to normalize the children with.
+     * @param statistics The statistics to update.
+     * @param callback The callback function to invoke for each child and the push leading to it.
+     */
+    void expand(
+        const SokobanState& state,
+        SokobanReachability& reachability,
+        SokobanReachability& childReachability,
+        SolverStatistics& statistics,
+        const std::function<void(const SokobanState&, const Push&)>& callback) const;
+
+    /**
+     * @brief Fills the moves and the LURD string of a solution from its pushes.
+     */
+    void completeMoves(Solution& solution) const;
+
+    /**
+     * @brief Returns whether a box that has just been pushed to a specified index is frozen off a
+     * storage, which makes the state unsolvable.
+     */
+    [[nodiscard]] bool isFreezeDeadlock(const SokobanState& state, int boxIndex) const;
+
+    /**
+     * @brief Returns whether a box cannot be moved along either axis. Boxes in the frozen set are
+     * treated as walls.
+     */
+    [[nodiscard]] bool
+    isFrozen(const SokobanState& state, int boxIndex, std::unordered_set<int>& frozenSet) const;
+
+    /**
+     * @brief Appends the moves that walk the player from one tile to another without pushing a
+     * box. The target must be reachable.
+     */
+    void appendWalk(
+        const SokobanState& state, int fromIndex, int toIndex, std::vector<Direction>& moves) const;
+
+    /**
+     * @brief The initial state, whose player is at the original location.
+     */
+    SokobanState m_initialState;
+
+    /**
+     * @brief The analysis of the level, which provides the push distances and the dead squares.
+     */
+    std::shared_ptr<const SokobanLevelAnalysis> m_analysis;
+
+    /**
+     * @brief The indices of the storages, in the order of the storage ordinals of the analysis.
+     */
+    std::vector<int> m_storages;
+
+    /**
+     * @brief The number of boxes.
+     */
+    int m_boxCount = 0;
+};
+
+}  // namespace SB
+
+#endif
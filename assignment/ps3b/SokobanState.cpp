@@ -0,0 +1,178 @@
+// Copyright 2024 James Chen
+
+#include "SokobanState.hpp"
+#include <bitset>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Returns the next number of a SplitMix64 sequence; used to generate Zobrist keys.
+ * @param seed The state of the sequence, which is advanced.
+ */
+uint64_t split_mix_64(uint64_t& seed) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+namespace SB {
+
+// The number of bits in a bitboard word
+constexpr int WORD_BITS = 64;
+
+SokobanBitboard::SokobanBitboard(const int size) : m_words((size + WORD_BITS - 1) / WORD_BITS, 0) {}
+
+bool SokobanBitboard::test(const int index) const {
+    return (m_words[index / WORD_BITS] >> (index % WORD_BITS)) & 1ULL;
+}
+
+void SokobanBitboard::set(const int index) {
+    m_words[index / WORD_BITS] |= 1ULL << (index % WORD_BITS);
+}
+
+void SokobanBitboard::reset(const int index) {
+    m_words[index / WORD_BITS] &= ~(1ULL << (index % WORD_BITS));
+}
+
+int SokobanBitboard::count() const {
+    int count = 0;
+    for (const auto word : m_words) {
+        count += static_cast<int>(std::bitset<WORD_BITS>(word).count());
+    }
+
+    return count;
+}
+
+void SokobanBitboard::forEach(const std::function<void(int)>& callback) const {
+    for (std::size_t i = 0; i < m_words.size(); ++i) {
+        // Pop the lowest set bit until the word runs out of bits
+        for (auto word = m_words[i]; word != 0; word &= word - 1) {
+            callback(static_cast<int>(i) * WORD_BITS + __builtin_ctzll(word));
+        }
+    }
+}
+
+bool SokobanBitboard::operator==(const SokobanBitboard& other) const {
+    return m_words == other.m_words;
+}
+
+bool SokobanBitboard::operator!=(const SokobanBitboard& other) const { return !(*this == other); }
+
+SokobanBoard::SokobanBoard(
+    const int width, const int height, const std::vector<TileChar>& tileCharGrid) :
+    m_width(width),
+    m_height(height),
+    m_walls(width * height),
+    m_storages(width * height) {
+    const auto size = width * height;
+    for (int i = 0; i < size; ++i) {
+        const auto tileChar = tileCharGrid[i];
+        if (tileChar == TileChar::Wall) {
+            m_walls.set(i);
+        } else if (tileChar == TileChar::Storage || tileChar == TileChar::BoxStorage ||
+                   tileChar == TileChar::PlayerStorage) {
+            m_storages.set(i);
+        }
+    }
+
+    // The keys are generated from a fixed seed, so that the same level always has the same hashes
+    uint64_t seed = 0;
+    m_boxKeys.reserve(size);
+    m_playerKeys.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        m_boxKeys.push_back(split_mix_64(seed));
+        m_playerKeys.push_back(split_mix_64(seed));
+    }
+}
+
+int SokobanBoard::width() const { return m_width; }
+
+int SokobanBoard::height() const { return m_height; }
+
+int SokobanBoard::size() const { return m_width * m_height; }
+
+bool SokobanBoard::isWall(const int index) const { return m_walls.test(index); }
+
+bool SokobanBoard::isStorage(const int index) const { return m_storages.test(index); }
+
+int SokobanBoard::neighbor(const int index, const Direction direction) const {
+    const auto col = index % m_width;
+    const auto row = index / m_width;
+    switch (direction) {
+        case Direction::Up:
+            return row > 0 ? index - m_width : -1;
+        case Direction::Down:
+            return row < m_height - 1 ? index + m_width : -1;
+        case Direction::Left:
+            return col > 0 ? index - 1 : -1;
+        case Direction::Right:
+            return col < m_width - 1 ? index + 1 : -1;
+    }
+
+    return -1;
+}
+
+uint64_t SokobanBoard::boxKey(const int index) const { return m_boxKeys[index]; }
+
+uint64_t SokobanBoard::playerKey(const int index) const { return m_playerKeys[index]; }
+
+SokobanState::SokobanState(
+    std::shared_ptr<const SokobanBoard> board,
+    const std::vector<TileChar>& tileCharGrid,
+    const int playerIndex) :
+    m_board(std::move(board)), m_boxes(m_board->size()), m_playerIndex(playerIndex) {
+    for (int i = 0; i < m_board->size(); ++i) {
+        const auto tileChar = tileCharGrid[i];
+        if (tileChar == TileChar::Box || tileChar == TileChar::BoxStorage) {
+            m_boxes.set(i);
+            m_hash ^= m_board->boxKey(i);
+        }
+    }
+
+    m_hash ^= m_board->playerKey(playerIndex);
+}
+
+const SokobanBoard& SokobanState::board() const { return *m_board; }
+
+int SokobanState::playerIndex() const { return m_playerIndex; }
+
+bool SokobanState::hasBox(const int index) const { return m_boxes.test(index); }
+
+const SokobanBitboard& SokobanState::boxes() const { return m_boxes; }
+
+TileChar SokobanState::tileChar(const int index) const {
+    if (m_board->isWall(index)) {
+        return TileChar::Wall;
+    }
+
+    if (m_board->isStorage(index)) {
+        return m_boxes.test(index) ? TileChar::BoxStorage : TileChar::Storage;
+    }
+
+    return m_boxes.test(index) ? TileChar::Box : TileChar::Empty;
+}
+
+uint64_t SokobanState::hash() const { return m_hash; }
+
+void SokobanState::movePlayer(const int index) {
+    m_hash ^= m_board->playerKey(m_playerIndex) ^ m_board->playerKey(index);
+    m_playerIndex = index;
+}
+
+void SokobanState::moveBox(const int fromIndex, const int toIndex) {
+    m_boxes.reset(fromIndex);
+    m_boxes.set(toIndex);
+    m_hash ^= m_board->boxKey(fromIndex) ^ m_board->boxKey(toIndex);
+}
+
+bool SokobanState::operator==(const SokobanState& other) const {
+    return m_hash == other.m_hash && m_playerIndex == other.m_playerIndex &&
+           m_boxes == other.m_boxes;
+}
+
+bool SokobanState::operator!=(const SokobanState& other) const { return !(*this == other); }
+
+}  // namespace SB
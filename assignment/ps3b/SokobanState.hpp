@@ -0,0 +1,273 @@
+// Copyright 2024 James Chen
+
+#ifndef SOKOBANSTATE_HPP
+#define SOKOBANSTATE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "SokobanConstants.hpp"
+
+namespace SB {
+
+/**
+ * @brief A fixed-size set of bits packed into 64-bit words. Bit i corresponds to the tile whose
+ * row-major index is i.
+ */
+class SokobanBitboard {
+ public:
+    /**
+     * @brief Creates an empty bitboard.
+     */
+    SokobanBitboard() = default;
+
+    /**
+     * @brief Creates a bitboard that holds a specified number of bits; all bits are cleared.
+     * @param size The number of bits.
+     */
+    explicit SokobanBitboard(int size);
+
+    /**
+     * @brief Returns whether the bit at a specified index is set.
+     */
+    [[nodiscard]] bool test(int index) const;
+
+    /**
+     * @brief Sets the bit at a specified index.
+     */
+    void set(int index);
+
+    /**
+     * @brief Clears the bit at a specified index.
+     */
+    void reset(int index);
+
+    /**
+     * @brief Returns the number of set bits.
+     */
+    [[nodiscard]] int count() const;
+
+    /**
+     * @brief Invokes the callback for the index of each set bit, in ascending order.
+     * @param callback The callback function to invoke.
+     */
+    void forEach(const std::function<void(int)>& callback) const;
+
+    /**
+     * @brief Checks if two bitboards contain the same bits.
+     */
+    bool operator==(const SokobanBitboard& other) const;
+
+    /**
+     * @brief Checks if two bitboards contain different bits.
+     */
+    bool operator!=(const SokobanBitboard& other) const;
+
+ private:
+    /**
+     * @brief The words that store the bits.
+     */
+    std::vector<uint64_t> m_words;
+};
+
+/**
+ * @brief The static part of a level, which never changes during a game: the walls, the storages
+ * and the Zobrist keys used to hash states. A board is shared by all states of the same level.
+ */
+class SokobanBoard {
+ public:
+    /**
+     * @brief Creates a board from a tile char grid in row-major order.
+     * @param width The number of tile columns.
+     * @param height The number of tile rows.
+     * @param tileCharGrid The tile char grid.
+     */
+    SokobanBoard(int width, int height, const std::vector<TileChar>& tileCharGrid);
+
+    /**
+     * @brief Returns the number of tile columns.
+     */
+    [[nodiscard]] int width() const;
+
+    /**
+     * @brief Returns the number of tile rows.
+     */
+    [[nodiscard]] int height() const;
+
+    /**
+     * @brief Returns the number of tiles.
+     */
+    [[nodiscard]] int size() const;
+
+    /**
+     * @brief Returns whether the tile at a specified index is a wall.
+     */
+    [[nodiscard]] bool isWall(int index) const;
+
+    /**
+     * @brief Returns whether the tile at a specified index is a storage.
+     */
+    [[nodiscard]] bool isStorage(int index) const;
+
+    /**
+     * @brief Returns the index of the neighbor of a tile towards a specified direction; returns -1
+     * if the neighbor is out of the map.
+     */
+    [[nodiscard]] int neighbor(int index, Direction direction) const;
+
+    /**
+     * @brief Returns the Zobrist key of a box standing at a specified index.
+     */
+    [[nodiscard]] uint64_t boxKey(int index) const;
+
+    /**
+     * @brief Returns the Zobrist key of the player standing at a specified index.
+     */
+    [[nodiscard]] uint64_t playerKey(int index) const;
+
+ private:
+    /**
+     * @brief The number of tile columns.
+     */
+    int m_width;
+
+    /**
+     * @brief The number of tile rows.
+     */
+    int m_height;
+
+    /**
+     * @brief The wall bitboard.
+     */
+    SokobanBitboard m_walls;
+
+    /**
+     * @brief The storage bitboard.
+     */
+    SokobanBitboard m_storages;
+
+    /**
+     * @brief The Zobrist keys of boxes, one for each tile.
+     */
+    std::vector<uint64_t> m_boxKeys;
+
+    /**
+     * @brief The Zobrist keys of the player, one for each tile.
+     */
+    std::vector<uint64_t> m_playerKeys;
+};
+
+/**
+ * @brief A compact game state: the box bitboard and the player's index on top of a shared board.
+ * The hash is maintained incrementally, so hashing a state takes constant time.
+ */
+class SokobanState {
+ public:
+    /**
+     * @brief Creates a state from a tile char grid in row-major order. Boxes are read from the
+     * grid; walls and storages are read from the board.
+     * @param board The board that the state belongs to.
+     * @param tileCharGrid The tile char grid.
+     * @param playerIndex The index of the player.
+     */
+    SokobanState(
+        std::shared_ptr<const SokobanBoard> board,
+        const std::vector<TileChar>& tileCharGrid,
+        int playerIndex);
+
+    /**
+     * @brief Returns the board that the state belongs to.
+     */
+    [[nodiscard]] const SokobanBoard& board() const;
+
+    /**
+     * @brief Returns the index of the player.
+     */
+    [[nodiscard]] int playerIndex() const;
+
+    /**
+     * @brief Returns whether there is a box at a specified index.
+     */
+    [[nodiscard]] bool hasBox(int index) const;
+
+    /**
+     * @brief Returns the box bitboard.
+     */
+    [[nodiscard]] const SokobanBitboard& boxes() const;
+
+    /**
+     * @brief Returns the tile character at a specified index, which is derived from the board and
+     * the box bitboard. The player is not included.
+     */
+    [[nodiscard]] TileChar tileChar(int index) const;
+
+    /**
+     * @brief Returns the Zobrist hash of the state.
+     */
+    [[nodiscard]] uint64_t hash() const;
+
+    /**
+     * @brief Moves the player to a specified index.
+     * @param index The index to move to.
+     */
+    void movePlayer(int index);
+
+    /**
+     * @brief Moves a box from one index to another. Note that there must be a box at the from
+     * index.
+     * @param fromIndex The index of the box.
+     * @param toIndex The index to move the box to.
+     */
+    void moveBox(int fromIndex, int toIndex);
+
+    /**
+     * @brief Checks if two states have the same boxes and the same player index.
+     */
+    bool operator==(const SokobanState& other) const;
+
+    /**
+     * @brief Checks if two states are different.
+     */
+    bool operator!=(const SokobanState& other) const;
+
+ private:
+    /**
+     * @brief The board that the state belongs to.
+     */
+    std::shared_ptr<const SokobanBoard> m_board;
+
+    /**
+     * @brief The box bitboard.
+     */
+    SokobanBitboard m_boxes;
+
+    /**
+     * @brief The index of the player.
+     */
+    int m_playerIndex;
+
+    /**
+     * @brief The Zobrist hash, which is the XOR of the keys of all boxes and the player.
+     */
+    uint64_t m_hash = 0;
+};
+
+}  // namespace SB
+
+namespace std {
+
+/**
+ * @brief Hashes a Sokoban state with its Zobrist hash, so that states can be stored in unordered
+ * containers.
+ */
+template <>
+struct hash<SB::SokobanState> {
+    std::size_t operator()(const SB::SokobanState& state) const noexcept {
+        return static_cast<std::size_t>(state.hash());
+    }
+};
+
+}  // namespace std
+
+#endif
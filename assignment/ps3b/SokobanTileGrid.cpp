@@ -1,96 +1,163 @@
 // Copyright 2024 James Chen
 
 #include "SokobanTileGrid.hpp"
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <SFML/Graphics.hpp>
-#include "InvalidCoordinateException.hpp"
+#include "FrameProfiler.hpp"
 
 namespace SB {
 
-SokobanTileGrid::SokobanTileGrid() {
-    const auto groundTexture{ std::make_shared<sf::Texture>() };
-    const auto groundStorageTexture{ std::make_shared<sf::Texture>() };
-    const auto boxTexture{ std::make_shared<sf::Texture>() };
-    const auto wallTexture{ std::make_shared<sf::Texture>() };
-    groundTexture->loadFromFile(TILE_GROUND_01_FILENAME);
-    groundStorageTexture->loadFromFile(TILE_GROUND_04_FILENAME);
-    boxTexture->loadFromFile(TILE_CRATE_03_FILENAME);
-    wallTexture->loadFromFile(TILE_BLOCK_06_FILENAME);
-
-    m_tileTextureMap[TileChar::Player] = { groundTexture };
-    m_tileTextureMap[TileChar::Empty] = { groundTexture };
-    m_tileTextureMap[TileChar::Wall] = { wallTexture };
-    m_tileTextureMap[TileChar::Box] = { boxTexture };
-    m_tileTextureMap[TileChar::Storage] = { groundStorageTexture };
-    m_tileTextureMap[TileChar::BoxStorage] = { boxTexture };
+SokobanTileGrid::SokobanTileGrid(std::shared_ptr<const SokobanAtlas> atlas) :
+    m_atlas(std::move(atlas)) {}
+
+std::size_t SokobanTileGrid::builtChunkCount() const {
+    return std::count_if(m_chunks.begin(), m_chunks.end(), [](const TileChunk& chunk) {
+        return chunk.isBuilt;
+    });
 }
 
 void SokobanTileGrid::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    traverseTileCharGrid([&](auto coordinate, auto tileChar) {
-        const sf::Vector2f position({ static_cast<float>(coordinate.x * TILE_WIDTH),
-                                      static_cast<float>(coordinate.y * TILE_HEIGHT) });
-        const auto tile = getTile(tileChar);
-        tile->setPosition(position);
-        target.draw(*tile);
-
-        return false;
-    });
+    if (m_width * m_height == 0) {
+        return;
+    }
+
+    // Create the chunks once per level; they are built when they become visible
+    const auto chunkRows = (m_height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (m_chunks.empty()) {
+        m_chunkColumns = (m_width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        m_chunks.resize(static_cast<std::size_t>(m_chunkColumns * chunkRows));
+    }
+    ++m_frame;
+
+    // Find the chunks that overlap the view; the view is not rotated
+    const auto& view = target.getView();
+    const auto viewLeft = view.getCenter().x - view.getSize().x / 2.0f;
+    const auto viewTop = view.getCenter().y - view.getSize().y / 2.0f;
+    const auto chunkWidth = static_cast<float>(CHUNK_SIZE * TILE_WIDTH);
+    const auto chunkHeight = static_cast<float>(CHUNK_SIZE * TILE_HEIGHT);
+    const auto firstColumn = std::max(0, static_cast<int>(std::floor(viewLeft / chunkWidth)));
+    const auto firstRow = std::max(0, static_cast<int>(std::floor(viewTop / chunkHeight)));
+    const auto lastColumn = std::min(
+        m_chunkColumns - 1,
+        static_cast<int>(std::floor((viewLeft + view.getSize().x) / chunkWidth)));
+    const auto lastRow = std::min(
+        chunkRows - 1, static_cast<int>(std::floor((viewTop + view.getSize().y) / chunkHeight)));
+
+    states.texture = &m_atlas->texture();
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const auto chunkIndex = column + row * m_chunkColumns;
+            auto& chunk = m_chunks[chunkIndex];
+            if (!chunk.isBuilt) {
+                buildChunk(chunk, chunkIndex);
+            }
+            drawChunk(chunk, target, states);
+        }
+    }
+
+    releaseHiddenChunks();
 }
 
-int SokobanTileGrid::getIndex(const sf::Vector2i& coordinate) const {
-    return coordinate.x + coordinate.y * m_width;
+void SokobanTileGrid::onTileCharChanged(const int index) {
+    // The chunks that are not built read the tile char grid when they are built
+    if (m_chunks.empty()) {
+        return;
+    }
+
+    auto& chunk = m_chunks[getChunkIndex(index)];
+    if (chunk.isBuilt) {
+        updateQuad(chunk, index);
+        chunk.dirtyTiles.push_back(getTileOrdinal(index));
+    }
 }
 
-int SokobanTileGrid::height() const { return m_height; }
+void SokobanTileGrid::onTileCharGridReset() { m_chunks.clear(); }
 
-int SokobanTileGrid::width() const { return m_width; }
+int SokobanTileGrid::getChunkIndex(const int tileIndex) const {
+    const auto column = tileIndex % m_width / CHUNK_SIZE;
+    const auto row = tileIndex / m_width / CHUNK_SIZE;
 
-TileChar SokobanTileGrid::getTileChar(const sf::Vector2i& coordinate) const {
-    return m_tileCharGrid.at(checkCoordinate(coordinate));
+    return column + row * m_chunkColumns;
 }
 
-void SokobanTileGrid::setTileChar(const sf::Vector2i& coordinate, const TileChar tileChar) {
-    const auto index = checkCoordinate(coordinate);
-    const auto originalTileChar = m_tileCharGrid[index];
+int SokobanTileGrid::getTileOrdinal(const int tileIndex) const {
+    // The chunks in the last column may be narrower than the others
+    const auto column = tileIndex % m_width;
+    const auto chunkLeft = column / CHUNK_SIZE * CHUNK_SIZE;
+    const auto chunkWidth = std::min(CHUNK_SIZE, m_width - chunkLeft);
 
-    if (originalTileChar != tileChar) {
-        m_tileCharGrid[index] = tileChar;
-        const auto newTile{ std::make_shared<sf::Sprite>() };
-        newTile->setTexture(*m_tileTextureMap.at(tileChar));
-    }
+    return column - chunkLeft + tileIndex / m_width % CHUNK_SIZE * chunkWidth;
 }
 
-void SokobanTileGrid::traverseTileCharGrid(
-    const std::function<bool(sf::Vector2i, TileChar)>& callback) const {
-    auto stopIteration = false;
-    for (int row = 0; !stopIteration && row < m_height; ++row) {
-        for (int col = 0; !stopIteration && col < m_width; ++col) {
-            const auto tileChar = getTileChar({ col, row });
-            stopIteration = callback({ col, row }, tileChar);
+void SokobanTileGrid::updateQuad(TileChunk& chunk, const int tileIndex) const {
+    const sf::Vector2f position{ static_cast<float>(tileIndex % m_width * TILE_WIDTH),
+                                 static_cast<float>(tileIndex / m_width * TILE_HEIGHT) };
+    SokobanAtlas::setQuad(&chunk.vertices[getTileOrdinal(tileIndex) * 4],
+                          position,
+                          m_atlas->tileRect(tileCharAt(tileIndex)));
+}
+
+void SokobanTileGrid::buildChunk(TileChunk& chunk, const int chunkIndex) const {
+    const auto left = chunkIndex % m_chunkColumns * CHUNK_SIZE;
+    const auto top = chunkIndex / m_chunkColumns * CHUNK_SIZE;
+    const auto right = std::min(left + CHUNK_SIZE, m_width);
+    const auto bottom = std::min(top + CHUNK_SIZE, m_height);
+
+    chunk.vertices.resize(static_cast<std::size_t>((right - left) * (bottom - top)) * 4);
+    for (int row = top; row < bottom; ++row) {
+        for (int column = left; column < right; ++column) {
+            updateQuad(chunk, column + row * m_width);
         }
     }
+    chunk.isBuilt = true;
+    chunk.isBufferStale = true;
+    chunk.dirtyTiles.clear();
 }
 
-std::shared_ptr<sf::Sprite> SokobanTileGrid::getTile(const TileChar& tileChar) const {
-    const auto it = m_tileTextureMap.find(tileChar);
-    if (it == m_tileTextureMap.end()) {
-        return nullptr;
+void SokobanTileGrid::drawChunk(
+    TileChunk& chunk, sf::RenderTarget& target, const sf::RenderStates states) const {
+    chunk.lastDrawnFrame = m_frame;
+    if (!sf::VertexBuffer::isAvailable()) {
+        target.draw(chunk.vertices, states);
+        FP::countDrawCall();
+        chunk.dirtyTiles.clear();
+        return;
     }
 
-    const auto sprite{ std::make_shared<sf::Sprite>() };
-    sprite->setTexture(*it->second);
+    // Upload the whole chunk when it is built, otherwise only the quads of the changed tiles
+    if (!chunk.vertexBuffer) {
+        chunk.vertexBuffer =
+            std::make_unique<sf::VertexBuffer>(sf::Quads, sf::VertexBuffer::Dynamic);
+        chunk.isBufferStale = true;
+    }
+    if (chunk.isBufferStale) {
+        chunk.vertexBuffer->create(chunk.vertices.getVertexCount());
+        chunk.vertexBuffer->update(&chunk.vertices[0]);
+        chunk.isBufferStale = false;
+    } else {
+        for (const auto ordinal : chunk.dirtyTiles) {
+            chunk.vertexBuffer->update(&chunk.vertices[ordinal * 4], 4, ordinal * 4);
+        }
+    }
+    chunk.dirtyTiles.clear();
 
-    return sprite;
+    target.draw(*chunk.vertexBuffer, states);
+    FP::countDrawCall();
 }
 
-int SokobanTileGrid::checkCoordinate(const sf::Vector2i& coordinate) const {
-    const auto index = getIndex(coordinate);
-    const auto gridSize = static_cast<int>(m_initialTileCharGrid.size());
-    if (index < 0 || index >= gridSize) {
-        throw InvalidCoordinateException(coordinate);
+void SokobanTileGrid::releaseHiddenChunks() const {
+    if (builtChunkCount() <= MAX_BUILT_CHUNKS) {
+        return;
     }
 
-    return index;
+    for (auto& chunk : m_chunks) {
+        if (chunk.isBuilt && chunk.lastDrawnFrame != m_frame) {
+            chunk = TileChunk{};
+        }
+    }
 }
 
 }  // namespace SB
@@ -3,119 +3,150 @@
 #ifndef SOKOBANTILEGRID_HPP
 #define SOKOBANTILEGRID_HPP
 
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 #include <SFML/Graphics.hpp>
+#include "SokobanAtlas.hpp"
 #include "SokobanConstants.hpp"
+#include "SokobanGame.hpp"
 
 namespace SB {
 
 /**
- * @brief This class manages the tile grid system in Sokoban. Tiles includes the unmovable things in
- * the game, inlcuding wall blocks, ground blocks, box blocks, and so on. Note the player is not
- * included in tiles.
+ * @brief This class draws the tile grid of a game. Tiles includes the unmovable things in the game,
+ * inlcuding wall blocks, ground blocks, box blocks, and so on. Note the player is not included in
+ * tiles.
  */
-class SokobanTileGrid : public virtual sf::Drawable {
+class SokobanTileGrid : public virtual sf::Drawable, public virtual SokobanGame {
  public:
     /**
-     * @brief Returns the width of the game board, which is the number of tile columns.
+     * @brief Returns the number of chunks of the tile layer that are built.
      */
-    [[nodiscard]] int width() const;
+    [[nodiscard]] std::size_t builtChunkCount() const;
 
+ protected:
     /**
-     * @brief Returns the height of the game board, which is the number of the tile rows.
+     * @brief Creates a SokobanTileGrid instance.
+     * @param atlas The texture atlas that contains the tiles.
      */
-    [[nodiscard]] int height() const;
+    explicit SokobanTileGrid(std::shared_ptr<const SokobanAtlas> atlas);
 
     /**
-     * @brief Returns the tile character at a specified coordinate.
-     * @param coordinate The coordinate of the tile character to get.
+     * @brief draws the tile grid onto the target. The tile layer is split into chunks of
+     * CHUNK_SIZE x CHUNK_SIZE tiles, and only the chunks that overlap the view of the target are
+     * drawn. A chunk batches its tiles into quads textured from the atlas; it is built the first
+     * time it is visible, afterwards only the quads of the tiles changed since the last frame are
+     * updated, and it is drawn in one call.
      */
-    [[nodiscard]] TileChar getTileChar(const sf::Vector2i& coordinate) const;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
- protected:
     /**
-     * @brief Creates a SokobanTileGrid instance; initalizes the tile texture map.
+     * @brief Marks the tile to be updated on the tile layer in the next frame.
      */
-    SokobanTileGrid();
+    void onTileCharChanged(int index) override;
 
     /**
-     * @brief draws the tile grid onto the target.
+     * @brief Marks the whole tile layer to be rebuilt in the next frame.
      */
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void onTileCharGridReset() override;
+
+    /**
+     * @brief The texture atlas that contains the tiles. Refer to `SokobanAtlas.hpp` for additional
+     * details.
+     */
+    std::shared_ptr<const SokobanAtlas> m_atlas;
 
+ private:
     /**
-     * @brief Returns the corresponding index of a specified coordiante.
-     * @param coordinate Coordinate to analyze.
+     * @brief The maximum number of chunks to keep built; the chunks that are not visible are
+     * released when there are more.
      */
-    [[nodiscard]] int getIndex(const sf::Vector2i& coordinate) const;
+    static constexpr std::size_t MAX_BUILT_CHUNKS = 64;
 
     /**
-     * @brief Sets the tile character for a specified coordiante. If the tile character changes, the
-     * corresponding tile in the tile grid changes synchronously.
-     * @param coordinate The coordiante of the tile character to set.
-     * @param tileChar The tile character to set.
+     * @brief A chunk of the tile layer.
      */
-    void setTileChar(const sf::Vector2i& coordinate, TileChar tileChar);
+    struct TileChunk {
+        /**
+         * @brief Whether the quads have been built from the tile char grid.
+         */
+        bool isBuilt = false;
+
+        /**
+         * @brief Four vertices for each tile of the chunk, in row-major order within the chunk.
+         */
+        sf::VertexArray vertices{ sf::Quads };
+
+        /**
+         * @brief The copy of the quads in graphics memory. It is created when the chunk is first
+         * drawn, so that a tile grid can be used without a graphics context until it is drawn.
+         */
+        std::unique_ptr<sf::VertexBuffer> vertexBuffer;
+
+        /**
+         * @brief Whether all the quads must be uploaded to the vertex buffer.
+         */
+        bool isBufferStale = true;
+
+        /**
+         * @brief The ordinals within the chunk of the tiles that have changed since the chunk was
+         * last drawn.
+         */
+        std::vector<int> dirtyTiles;
+
+        /**
+         * @brief The frame in which the chunk was last drawn.
+         */
+        uint64_t lastDrawnFrame = 0;
+    };
 
     /**
-     * @brief Iterates over each tile character in the grid and invokes the specified callback
-     * function for each tile, providing the tile's coordinate and its associated tile character.
-     * The callback function should return true to continue the traversal or false to stop it.
-     * @param callback The callback function is to be invoked for each tile.
+     * @brief Returns the index of the chunk that contains the tile at a specified index.
      */
-    void traverseTileCharGrid(const std::function<bool(sf::Vector2i, TileChar)>& callback) const;
+    [[nodiscard]] int getChunkIndex(int tileIndex) const;
 
     /**
-     * @brief Converts a character into the corresponding tile sprite.
-     * @return The corresponding tile sprite; nullptr if the tile char is not supported.
+     * @brief Returns the ordinal of the tile at a specified index within its chunk.
      */
-    [[nodiscard]] std::shared_ptr<sf::Sprite> getTile(const TileChar& tileChar) const;
+    [[nodiscard]] int getTileOrdinal(int tileIndex) const;
 
     /**
-     * @brief The number of tile columns.
+     * @brief Sets the quad of a tile in its chunk.
      */
-    int m_width = 0;
+    void updateQuad(TileChunk& chunk, int tileIndex) const;
 
     /**
-     * @brief The number of tile rows.
+     * @brief Builds all the quads of a chunk.
      */
-    int m_height = 0;
+    void buildChunk(TileChunk& chunk, int chunkIndex) const;
 
     /**
-     * @brief Associates characters with their respective tile texture. Refer to
-     * `SokobanConstants.h` for additional details. This mapping is crucial for constructing the
-     * sprite grid.
+     * @brief Draws a chunk after the changed tiles are applied.
      */
-    std::unordered_map<TileChar, std::shared_ptr<sf::Texture>> m_tileTextureMap;
+    void drawChunk(TileChunk& chunk, sf::RenderTarget& target, sf::RenderStates states) const;
 
     /**
-     * @brief The initial tile char grid. It is unchanged until the level changes.
+     * @brief Releases the built chunks that were not drawn in the current frame if too many chunks
+     * are built.
      */
-    std::vector<TileChar> m_initialTileCharGrid;
+    void releaseHiddenChunks() const;
 
     /**
-     * @brief Represents the tile character grid, which is mapping into an one-dimentional array in
-     * row-major order.
+     * @brief The number of chunk columns.
      */
-    std::vector<TileChar> m_tileCharGrid;
+    mutable int m_chunkColumns = 0;
 
     /**
-     * @brief Represents the tile grid, which is mapping into an one-dimentional array in row-major
-     * order.
+     * @brief The chunks of the tile layer in row-major order. It is empty until the first frame
+     * after a level is loaded.
      */
-    std::vector<std::shared_ptr<sf::Sprite>> m_tileGrid;
+    mutable std::vector<TileChunk> m_chunks;
 
- private:
     /**
-     * @brief Checks if a specified coordinate is valid. A valid coordiante should be able to be
-     * located in the tile char grid.
-     * @param coordinate The coordinate to check.
-     * @return A index corresponding to the coordinate.
-     * @throws InvalidCoordinateException if the coordinate is invalid.
+     * @brief The number of frames that have been drawn.
      */
-    [[nodiscard]] int checkCoordinate(const sf::Vector2i& coordinate) const;
+    mutable uint64_t m_frame = 0;
 };
 
 }  // namespace SB
@@ -0,0 +1,167 @@
+// Copyright 2024 James Chen
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AllocationCounter.hpp"
+#include "Sokoban.hpp"
+#include "SokobanGame.hpp"
+
+namespace {
+
+/**
+ * @brief Enumerates the operations of a scripted random walk.
+ */
+enum class Operation { Move, Undo, Reset };
+
+/**
+ * @brief A scripted operation; the direction is only meaningful for a move.
+ */
+struct ScriptStep {
+    Operation operation;
+    SB::Direction direction;
+};
+
+/**
+ * @brief Creates a random walk of a specified length from a seed: mostly moves, some undos and a
+ * few resets. The same seed always creates the same script, so runs can be compared.
+ */
+std::vector<ScriptStep> random_walk_script(const std::size_t length, const uint64_t seed) {
+    std::mt19937_64 random{ seed };
+    std::uniform_int_distribution<int> perMille{ 0, 999 };
+    std::vector<ScriptStep> script;
+    script.reserve(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        const auto roll = perMille(random);
+        const auto direction = SB::DIRECTIONS[random() % SB::DIRECTIONS.size()];
+        const auto operation = roll < 850 ? Operation::Move
+                               : roll < 999 ? Operation::Undo
+                                            : Operation::Reset;
+        script.push_back({ operation, direction });
+    }
+
+    return script;
+}
+
+/**
+ * @brief Returns the filenames of the level files in a directory in alphabetical order.
+ */
+std::vector<std::string> level_filenames(const std::string& levelDirectory) {
+    std::vector<std::string> filenames;
+    for (const auto& entry : std::filesystem::directory_iterator(levelDirectory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lvl") {
+            filenames.push_back(entry.path().string());
+        }
+    }
+    std::sort(filenames.begin(), filenames.end());
+
+    return filenames;
+}
+
+/**
+ * @brief Returns the seconds elapsed since a time point.
+ */
+double seconds_since(const std::chrono::steady_clock::time_point& startTime) {
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    return elapsedTime.count();
+}
+
+}  // namespace
+
+/**
+ * @brief Benchmarks the hot paths of Sokoban on every level in a directory, and prints one line
+ * for each level:
+ *   - The operations per second of a scripted random walk through movePlayer, undo and reset.
+ *   - The number of allocations made during the walk.
+ *   - The bytes retained by the move journal after the walk; a reset keeps its capacity.
+ *   - The time and the allocations to draw a frame into an offscreen render texture.
+ * Run it before and after a change of the engine to compare the numbers.
+ * @param size The size of the argument list.
+ * @param arguments The command line arguments, all optional:
+ *   --levels DIR  The directory of the level files; defaults to the level directory of the assets.
+ *   --steps N     The number of steps of the random walk; defaults to 1000000.
+ *   --frames N    The number of frames to draw; defaults to 200.
+ *   --seed N      The seed of the random walk; defaults to 1.
+ */
+int main(const int size, const char* arguments[]) {
+    auto levelDirectory = SB::LEVEL_DIR;
+    std::size_t stepCount = 1000000;
+    auto frameCount = 200;
+    uint64_t seed = 1;
+    for (int i = 1; i + 1 < size; i += 2) {
+        const std::string argument{ arguments[i] };
+        if (argument == "--levels") {
+            levelDirectory = arguments[i + 1];
+        } else if (argument == "--steps") {
+            stepCount = std::stoull(arguments[i + 1]);
+        } else if (argument == "--frames") {
+            frameCount = std::stoi(arguments[i + 1]);
+        } else if (argument == "--seed") {
+            seed = std::stoull(arguments[i + 1]);
+        } else {
+            std::cout << "Unknown option: " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    const auto script = random_walk_script(stepCount, seed);
+    for (const auto& levelFilename : level_filenames(levelDirectory)) {
+        // A won game ignores the moves, so it is reset to keep the whole script meaningful
+        SB::SokobanGame game{ levelFilename };
+        auto allocationCount = FP::allocationCount();
+        auto startTime = std::chrono::steady_clock::now();
+        for (const auto& [operation, direction] : script) {
+            if (operation == Operation::Move) {
+                game.movePlayer(direction);
+                if (game.isWon()) {
+                    game.reset();
+                }
+            } else if (operation == Operation::Undo) {
+                game.undo();
+            } else {
+                game.reset();
+            }
+        }
+        const auto walkSeconds = seconds_since(startTime);
+        const auto walkAllocations = FP::allocationCount() - allocationCount;
+
+        // Draw through the camera into a texture of the window size; the first frame builds the
+        // vertices, so it is timed separately
+        SB::Sokoban sokoban{ levelFilename };
+        sf::RenderTexture renderTexture;
+        renderTexture.create(
+            std::min(sokoban.width(), SB::MAX_WINDOW_COLUMNS) * SB::TILE_WIDTH,
+            std::min(sokoban.height(), SB::MAX_WINDOW_ROWS) * SB::TILE_HEIGHT);
+        startTime = std::chrono::steady_clock::now();
+        renderTexture.clear(sf::Color::White);
+        renderTexture.draw(sokoban);
+        renderTexture.display();
+        const auto firstFrameSeconds = seconds_since(startTime);
+
+        allocationCount = FP::allocationCount();
+        startTime = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frameCount; ++frame) {
+            renderTexture.clear(sf::Color::White);
+            renderTexture.draw(sokoban);
+            renderTexture.display();
+        }
+        const auto frameDivisor = std::max(frameCount, 1);
+        const auto frameSeconds = seconds_since(startTime) / frameDivisor;
+        const auto frameAllocations =
+            static_cast<double>(FP::allocationCount() - allocationCount) / frameDivisor;
+
+        const auto stepsPerSecond =
+            walkSeconds > 0.0 ? static_cast<double>(script.size()) / walkSeconds : 0.0;
+        std::cout << levelFilename << ": " << stepsPerSecond << " steps/s, " << walkAllocations
+                  << " allocations, " << game.journalBytes() << " journal bytes; draw "
+                  << frameSeconds * 1e6 << " us/frame (first " << firstFrameSeconds * 1e6
+                  << " us), " << frameAllocations << " allocations/frame" << std::endl;
+    }
+
+    return 0;
+}
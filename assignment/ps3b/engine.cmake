@@ -0,0 +1,21 @@
+# The Sokoban engine shared by ps3a, ps3b and the remake: the rules, the map and the states. The
+# sources are listed only here; each project that includes this file builds the same target.
+set(SOKOBAN_ENGINE_DIR ${CMAKE_CURRENT_LIST_DIR})
+add_library(sokoban-engine STATIC
+        ${SOKOBAN_ENGINE_DIR}/SokobanConstants.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanGame.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanGame.cpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanState.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanState.cpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanLevelAnalysis.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanLevelAnalysis.cpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanReachability.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanReachability.cpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanReplay.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanReplay.cpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanLevelPack.hpp
+        ${SOKOBAN_ENGINE_DIR}/SokobanLevelPack.cpp
+        ${SOKOBAN_ENGINE_DIR}/InvalidCoordinateException.hpp
+        ${SOKOBAN_ENGINE_DIR}/InvalidCoordinateException.cpp
+)
+target_include_directories(sokoban-engine PUBLIC ${SOKOBAN_ENGINE_DIR})
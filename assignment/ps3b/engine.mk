@@ -0,0 +1,22 @@
+# The Sokoban engine shared by ps3a, ps3b and the remake: the rules, the map and the states. The
+# Makefile that includes this file sets ENGINE to the directory of ps3b first, and builds the
+# engine object files in its own directory.
+
+# The engine hpp files (dependencies)
+ENGINE_DEPS = $(ENGINE)SokobanConstants.hpp \
+              $(ENGINE)SokobanGame.hpp \
+              $(ENGINE)SokobanState.hpp \
+              $(ENGINE)SokobanLevelAnalysis.hpp \
+              $(ENGINE)SokobanReachability.hpp \
+              $(ENGINE)SokobanReplay.hpp \
+              $(ENGINE)SokobanLevelPack.hpp \
+              $(ENGINE)InvalidCoordinateException.hpp
+
+# The engine object files
+ENGINE_OBJECTS = SokobanGame.o \
+                 SokobanState.o \
+                 SokobanLevelAnalysis.o \
+                 SokobanReachability.o \
+                 SokobanReplay.o \
+                 SokobanLevelPack.o \
+                 InvalidCoordinateException.o
@@ -0,0 +1,82 @@
+// Copyright 2024 James Chen
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "SokobanGenerator.hpp"
+
+/**
+ * @brief Generates Sokoban levels in a difficulty band and writes them to level files (.lvl)
+ * named generated-<seed>.lvl.
+ * @param size The size of the argument list.
+ * @param arguments The command line arguments. The following options are accepted:
+ *   --count N        Generates N levels; defaults to 10.
+ *   --threads N      Generates with N threads; defaults to 1.
+ *   --seed N         The seed of the first candidate; defaults to 1.
+ *   --size W H       The width and height of the levels; defaults to 10 10.
+ *   --boxes N        The number of boxes; defaults to 3.
+ *   --min-pushes N   The fewest pushes to solve a level in the band; defaults to 10.
+ *   --max-pushes N   The most pushes to solve a level in the band.
+ *   --min-nodes N    The fewest nodes expanded to solve a level in the band.
+ *   --max-nodes N    The most nodes expanded to solve a level in the band.
+ *   --output DIR     The directory to write the level files to; defaults to the current one.
+ */
+int main(const int size, const char* arguments[]) {
+    std::size_t count = 10;
+    auto threadCount = 1;
+    uint64_t firstSeed = 1;
+    auto width = 10;
+    auto height = 10;
+    auto boxCount = 3;
+    SB::DifficultyBand band;
+    band.minPushes = 10;
+    std::string outputDirectory = ".";
+    for (int i = 1; i < size; ++i) {
+        const std::string argument{ arguments[i] };
+        if (argument == "--count" && i + 1 < size) {
+            count = std::stoull(arguments[++i]);
+        } else if (argument == "--threads" && i + 1 < size) {
+            threadCount = std::stoi(arguments[++i]);
+        } else if (argument == "--seed" && i + 1 < size) {
+            firstSeed = std::stoull(arguments[++i]);
+        } else if (argument == "--size" && i + 2 < size) {
+            width = std::stoi(arguments[++i]);
+            height = std::stoi(arguments[++i]);
+        } else if (argument == "--boxes" && i + 1 < size) {
+            boxCount = std::stoi(arguments[++i]);
+        } else if (argument == "--min-pushes" && i + 1 < size) {
+            band.minPushes = std::stoi(arguments[++i]);
+        } else if (argument == "--max-pushes" && i + 1 < size) {
+            band.maxPushes = std::stoi(arguments[++i]);
+        } else if (argument == "--min-nodes" && i + 1 < size) {
+            band.minNodes = std::stoull(arguments[++i]);
+        } else if (argument == "--max-nodes" && i + 1 < size) {
+            band.maxNodes = std::stoull(arguments[++i]);
+        } else if (argument == "--output" && i + 1 < size) {
+            outputDirectory = arguments[++i];
+        } else {
+            std::cout << "Unknown argument: " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    if (threadCount < 1) {
+        std::cout << "The number of threads must be positive." << std::endl;
+        return 1;
+    }
+
+    // Give up after trying a thousand candidates for each level
+    const SB::SokobanGenerator generator{ width, height, boxCount };
+    const auto levels = generator.generate(count, band, threadCount, firstSeed, count * 1000);
+    for (const auto& level : levels) {
+        const auto filename = outputDirectory + "/generated-" + std::to_string(level.seed) + ".lvl";
+        std::ofstream ofstream{ filename };
+        ofstream << level.game << std::endl;
+        std::cout << filename << ": " << level.pushes << " pushes, " << level.expandedNodes
+                  << " nodes" << std::endl;
+    }
+
+    std::cout << levels.size() << " of " << count << " levels generated." << std::endl;
+
+    return levels.size() == count ? 0 : 2;
+}
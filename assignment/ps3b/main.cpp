@@ -1,14 +1,59 @@
 // Copyright 2024 James Chen
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include "FrameProfiler.hpp"
+#include "FrameProfilerOverlay.hpp"
 #include "Sokoban.hpp"
+#include "SokobanLevelPack.hpp"
+#include "SokobanPathPlanner.hpp"
+#include "SokobanScheduler.hpp"
+
+/**
+ * @brief The interval between two moves of the player following a planned path in microseconds.
+ */
+constexpr int64_t PLANNED_MOVE_INTERVAL_IN_MICROSECONDS = 60000;
+
+namespace {
+
+/**
+ * @brief Parses the number of a level in a level pack.
+ * @param argument The argument to parse, which must consist of decimal digits only.
+ * @param levelCount The number of levels in the pack.
+ * @return The level number from 1 to the number of levels, or nothing if the argument is not one.
+ */
+std::optional<std::size_t> parse_level_number(const std::string& argument,
+                                              const std::size_t levelCount) {
+    if (argument.empty() || argument.size() > 9 ||
+        !std::all_of(argument.begin(), argument.end(), [](const char c) {
+            return c >= '0' && c <= '9';
+        })) {
+        return std::nullopt;
+    }
+
+    const auto levelNumber = static_cast<std::size_t>(std::stoul(argument));
+    if (levelNumber < 1 || levelNumber > levelCount) {
+        return std::nullopt;
+    }
+
+    return levelNumber;
+}
+
+}  // namespace
 
 /**
  * @brief Starts a Sokoban game.
  * @param size The size of the argument list.
  * @param arguments The command line arguments. This game requires one argument, which is the
- * filename of the level file to load.
+ * filename of the level file to load. A file without the ".lvl" extension is opened as a level
+ * pack, optionally followed by the number of the level to start with; Page Down and Page Up switch
+ * to the next and previous levels of the pack. The options that follow are:
+ *   --profile     Shows the frame profiler overlay at the start; F3 toggles it anyway.
+ *   --trace FILE  Writes the measurements of every frame to a CSV file.
  */
 int main(const int size, const char* arguments[]) {
     // Check arguments
@@ -17,18 +62,66 @@ int main(const int size, const char* arguments[]) {
         return 1;
     }
 
-    // Create a Sokoban game object and load the level file
+    // Create a Sokoban game object and load the level file, or the first level of a level pack
     const std::string levelFilename{ arguments[1] };
-    SB::Sokoban sokoban{ levelFilename };
+    const std::string levelExtension{ ".lvl" };
+    const auto isLevelFile = levelFilename.size() >= levelExtension.size() &&
+                             levelFilename.compare(levelFilename.size() - levelExtension.size(),
+                                                   levelExtension.size(), levelExtension) == 0;
+    auto optionIndex = 2;
+    std::optional<SB::SokobanLevelPack> levelPack;
+    std::size_t levelIndex = 0;
+    if (!isLevelFile) {
+        levelPack.emplace(levelFilename);
+        if (levelPack->size() == 0) {
+            std::cout << "No levels found in " << levelFilename << "." << std::endl;
+            return 1;
+        }
+        if (size >= 3 && std::string{ arguments[2] }.rfind("--", 0) != 0) {
+            const auto levelNumber = parse_level_number(arguments[2], levelPack->size());
+            if (!levelNumber.has_value()) {
+                std::cout << "The level number must be between 1 and " << levelPack->size()
+                          << ": " << arguments[2] << std::endl;
+                return 1;
+            }
+            levelIndex = *levelNumber - 1;
+            ++optionIndex;
+        }
+    }
+
+    // Parse the profiler options
+    FP::FrameProfiler profiler;
+    auto isProfilerVisible = false;
+    for (int i = optionIndex; i < size; ++i) {
+        const std::string option{ arguments[i] };
+        if (option == "--profile") {
+            isProfilerVisible = true;
+        } else if (option == "--trace" && i + 1 < size) {
+            profiler.startTrace(arguments[++i]);
+        } else {
+            std::cout << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    SB::Sokoban sokoban;
+    sokoban.load(isLevelFile ? SB::SokobanGame{ levelFilename } : levelPack->load(levelIndex));
 
-    // Create a window based on the Sokoban game width and height
-    const auto windowWidth{ sokoban.width() * SB::TILE_WIDTH };
-    const auto windowHeight{ sokoban.height() * SB::TILE_HEIGHT };
+    // Create a window based on the Sokoban game width and height; larger maps scroll. The levels
+    // of a pack have different sizes, so the window takes the largest size
+    const auto columns = levelPack.has_value() ? SB::MAX_WINDOW_COLUMNS : sokoban.width();
+    const auto rows = levelPack.has_value() ? SB::MAX_WINDOW_ROWS : sokoban.height();
+    const auto windowWidth{ std::min(columns, SB::MAX_WINDOW_COLUMNS) * SB::TILE_WIDTH };
+    const auto windowHeight{ std::min(rows, SB::MAX_WINDOW_ROWS) * SB::TILE_HEIGHT };
     const auto windowVideoMode{ sf::VideoMode(windowWidth, windowHeight) };
     const auto windowTitle = SB::GAME_NAME + " by " + SB::AUTHOR_NAME;
     sf::RenderWindow window(windowVideoMode, windowTitle);
     window.setFramerateLimit(60);
 
+    // The overlay shows the frame time percentiles, draw calls and allocations per frame
+    FP::FrameProfilerOverlay profilerOverlay{ profiler, SB::FONT_ROBOTO_FILENAME };
+    profilerOverlay.setVisible(isProfilerVisible);
+
     // Create a map that binds keyboard keys to directions for the player to move
     // Initializer list syntax
     const std::unordered_map<const sf::Keyboard::Key, SB::Direction> movePlayerKeyMap{
@@ -42,9 +135,20 @@ int main(const int size, const char* arguments[]) {
         { sf::Keyboard::Key::Right, SB::Direction::Right }
     };
 
+    // Click-to-move: a click on a tile plans a walk to it; a click on a box selects the box, and
+    // the next click plans the pushes that bring the box to the clicked tile
+    SB::SokobanPathPlanner planner;
+    std::optional<sf::Vector2i> selectedBox;
+    std::deque<SB::Direction> plannedMoves;
+    int64_t plannedMoveElapsedTime = 0;
+
+    // The keys are queued as commands, and the game runs them in fixed steps apart from rendering
+    SB::SokobanScheduler scheduler;
+
     // Game loop
     sf::Clock clock;
     while (window.isOpen()) {
+        profiler.beginFrame();
         sf::Event event{};
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) {
@@ -52,32 +156,115 @@ int main(const int size, const char* arguments[]) {
                 break;
             }
 
+            // Listen to mouse click event
+            if (event.type == sf::Event::MouseButtonPressed) {
+                planner.cancel();
+                plannedMoves.clear();
+                // A right click drops the selection. A plan starts from the current position,
+                // which the commands queued in this frame are about to change, so a click is
+                // ignored until they have run
+                if (event.mouseButton.button != sf::Mouse::Left ||
+                    scheduler.pendingCommandCount() > 0) {
+                    selectedBox.reset();
+                    continue;
+                }
+
+                const auto view = sokoban.cameraView(window.getSize());
+                const sf::Vector2i pixel{ event.mouseButton.x, event.mouseButton.y };
+                const auto position = window.mapPixelToCoords(pixel, view);
+                const sf::Vector2i tile{ static_cast<int>(position.x) / SB::TILE_WIDTH,
+                                         static_cast<int>(position.y) / SB::TILE_HEIGHT };
+                if (position.x < 0 || position.y < 0 || tile.x >= sokoban.width() ||
+                    tile.y >= sokoban.height()) {
+                    continue;
+                }
+
+                const auto tileChar = sokoban.getTileChar(tile);
+                if (selectedBox.has_value()) {
+                    planner.planPush(sokoban, *selectedBox, tile);
+                    selectedBox.reset();
+                } else if (tileChar == SB::TileChar::Box || tileChar == SB::TileChar::BoxStorage) {
+                    selectedBox = tile;
+                } else {
+                    planner.planWalk(sokoban, tile);
+                }
+            }
+
             // Listen to keypress event
             if (event.type == sf::Event::KeyPressed) {
+                // Any key takes over from the planned path
+                planner.cancel();
+                plannedMoves.clear();
+                selectedBox.reset();
+
                 // Move player
                 const auto itDirection = movePlayerKeyMap.find(event.key.code);
                 if (itDirection != movePlayerKeyMap.end()) {
-                    sokoban.movePlayer(itDirection->second);
+                    scheduler.push({ SB::CommandType::Move, itDirection->second });
                 }
 
                 // Reset the game
                 if (event.key.code == sf::Keyboard::R) {
-                    sokoban.reset();
+                    scheduler.push({ SB::CommandType::Reset });
                 }
 
                 // Undo a move
                 if (event.key.code == sf::Keyboard::U) {
-                    sokoban.undo();
+                    scheduler.push({ SB::CommandType::Undo });
                 }
+
+                // Redo a move that has been undone
+                if (event.key.code == sf::Keyboard::Y) {
+                    scheduler.push({ SB::CommandType::Redo });
+                }
+
+                // Switch to the next or previous level of the pack; only that level is parsed
+                const auto isNextLevel = event.key.code == sf::Keyboard::PageDown;
+                const auto isPreviousLevel = event.key.code == sf::Keyboard::PageUp;
+                if (levelPack.has_value() && (isNextLevel || isPreviousLevel)) {
+                    const auto levelCount = levelPack->size();
+                    levelIndex = (levelIndex + (isNextLevel ? 1 : levelCount - 1)) % levelCount;
+                    scheduler.clear();
+                    sokoban.load(levelPack->load(levelIndex));
+                }
+
+                // Toggle the frame profiler overlay
+                if (event.key.code == sf::Keyboard::F3) {
+                    profilerOverlay.setVisible(!profilerOverlay.isVisible());
+                }
+            }
+        }
+
+        // Advance the plan within the time budget, and follow the path once it is found
+        profiler.beginSection(FP::Section::Update);
+        const auto dt = clock.restart().asMicroseconds();
+        if (planner.advance() == SB::PlanStatus::Found) {
+            plannedMoves.assign(planner.path().begin(), planner.path().end());
+            plannedMoveElapsedTime = 0;
+            planner.cancel();
+        }
+        if (!plannedMoves.empty()) {
+            plannedMoveElapsedTime += dt;
+            while (!plannedMoves.empty() &&
+                   plannedMoveElapsedTime >= PLANNED_MOVE_INTERVAL_IN_MICROSECONDS) {
+                plannedMoveElapsedTime -= PLANNED_MOVE_INTERVAL_IN_MICROSECONDS;
+                scheduler.push({ SB::CommandType::Move, plannedMoves.front() });
+                plannedMoves.pop_front();
             }
         }
 
-        sokoban.update(clock.restart().asMicroseconds());
+        scheduler.advance(sokoban, dt);
+        sokoban.setInterpolation(scheduler.interpolation());
+        profiler.endSection(FP::Section::Update);
 
         if (window.isOpen()) {
+            profiler.beginSection(FP::Section::Draw);
             window.clear(sf::Color::White);
             window.draw(sokoban);
+            window.draw(profilerOverlay);
+            profiler.endSection(FP::Section::Draw);
             window.display();
         }
+        profiler.endFrame();
     }
 }
@@ -0,0 +1,189 @@
+// Copyright 2024 James Chen
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SokobanGame.hpp"
+#include "SokobanLevelPack.hpp"
+#include "SokobanReplay.hpp"
+#include "SokobanSolver.hpp"
+
+namespace {
+
+/**
+ * @brief Returns the number of nodes expanded per second in a search.
+ */
+double nodes_per_second(const SB::SolverStatistics& statistics) {
+    return statistics.elapsedSeconds > 0.0
+               ? static_cast<double>(statistics.expandedNodes) / statistics.elapsedSeconds
+               : 0.0;
+}
+
+/**
+ * @brief Solves a level with a specified number of threads; the serial solver is used for a single
+ * thread.
+ */
+SB::Solution solve_level(
+    const SB::SokobanSolver& solver, const int threadCount, const uint64_t maxNodes) {
+    return threadCount == 1 ? solver.solve(maxNodes) : solver.solveParallel(threadCount, maxNodes);
+}
+
+/**
+ * @brief Replays the moves of a solution on a copy of a game in its initial state, and returns
+ * whether the copy is won.
+ */
+bool validate_solution(SB::SokobanGame game, const SB::Solution& solution) {
+    for (const auto direction : solution.moves) {
+        game.movePlayer(direction);
+    }
+
+    return game.isWon();
+}
+
+/**
+ * @brief Prints a solution: the pushes, the complete move sequence in LURD notation and the node
+ * statistics.
+ */
+void print_solution(
+    const std::string& levelFilename, const SB::SokobanGame& game, const SB::Solution& solution) {
+    const auto& statistics = solution.statistics;
+    if (solution.isSolved) {
+        std::cout << "Solved " << levelFilename << " in " << solution.pushes.size()
+                  << " pushes and " << solution.moves.size() << " moves." << std::endl;
+
+        // Print the pushes; the coordinates are the ones of the box before it is pushed
+        for (std::size_t i = 0; i < solution.pushes.size(); ++i) {
+            const auto& [boxIndex, direction] = solution.pushes[i];
+            std::cout << "  " << i + 1 << ". (" << boxIndex % game.width() << ", "
+                      << boxIndex / game.width() << ") "
+                      << SB::SokobanSolver::toLurd(direction, true) << std::endl;
+        }
+
+        // Print the moves; pushes are in upper case
+        std::cout << "Moves: " << solution.lurd << std::endl;
+    } else {
+        std::cout << "No solution found for " << levelFilename << "." << std::endl;
+    }
+
+    std::cout << "Expanded nodes: " << statistics.expandedNodes << std::endl;
+    std::cout << "Generated nodes: " << statistics.generatedNodes << std::endl;
+    std::cout << "Duplicate nodes: " << statistics.duplicateNodes << std::endl;
+    std::cout << "Deadlock nodes: " << statistics.deadlockNodes << std::endl;
+    std::cout << "Elapsed time: " << statistics.elapsedSeconds << " s ("
+              << nodes_per_second(statistics) << " nodes/s)" << std::endl;
+}
+
+}  // namespace
+
+/**
+ * @brief Solves Sokoban levels and prints the push sequences, the complete move sequences in LURD
+ * notation and the node statistics. When more than one level is given, every solution is replayed
+ * to make sure that it wins the level, and a summary is printed. Every level of a level pack is
+ * solved in this batch mode.
+ * @param size The size of the argument list.
+ * @param arguments The command line arguments. This program requires the filenames of the level
+ * files to solve, optionally preceded by the following options:
+ *   --threads N    Solves with N threads; defaults to 1.
+ *   --max-nodes N  Expands at most N nodes for each level.
+ *   --scaling      Solves each level with 1 to N threads and prints the nodes per second.
+ *   --replay FILE  Writes the moves of the solution to a replay file; only for a single level.
+ *   --pack FILE    Solves every level of a level pack; it can be given more than once.
+ */
+int main(const int size, const char* arguments[]) {
+    auto threadCount = 1;
+    auto maxNodes = SB::SokobanSolver::DEFAULT_MAX_NODES;
+    auto isScaling = false;
+    std::string replayFilename;
+    std::vector<std::string> levelFilenames;
+    std::vector<std::string> packFilenames;
+    for (int i = 1; i < size; ++i) {
+        const std::string argument{ arguments[i] };
+        if (argument == "--threads" && i + 1 < size) {
+            threadCount = std::stoi(arguments[++i]);
+        } else if (argument == "--max-nodes" && i + 1 < size) {
+            maxNodes = std::stoull(arguments[++i]);
+        } else if (argument == "--scaling") {
+            isScaling = true;
+        } else if (argument == "--replay" && i + 1 < size) {
+            replayFilename = arguments[++i];
+        } else if (argument == "--pack" && i + 1 < size) {
+            packFilenames.emplace_back(arguments[++i]);
+        } else {
+            levelFilenames.push_back(argument);
+        }
+    }
+
+    // Check arguments
+    if (levelFilenames.empty() && packFilenames.empty()) {
+        std::cout << "Too few arguments! Require the filename of the level file." << std::endl;
+        return 1;
+    }
+
+    if (threadCount < 1) {
+        std::cout << "The number of threads must be positive." << std::endl;
+        return 1;
+    }
+
+    auto levelCount = 0;
+    auto failureCount = 0;
+    const auto isSingleLevel = levelFilenames.size() == 1 && packFilenames.empty();
+    const auto solveGame = [&](const std::string& levelName, const SB::SokobanGame& game) {
+        const SB::SokobanSolver solver{ game.state(), game.analysis() };
+        ++levelCount;
+
+        if (isScaling) {
+            std::cout << levelName << std::endl;
+            for (int threads = 1; threads <= threadCount; ++threads) {
+                const auto solution = solver.solveParallel(threads, maxNodes);
+                std::cout << "  " << threads << " thread(s): " << solution.pushes.size()
+                          << " pushes, " << solution.statistics.expandedNodes << " nodes, "
+                          << solution.statistics.elapsedSeconds << " s, "
+                          << nodes_per_second(solution.statistics) << " nodes/s" << std::endl;
+            }
+            return;
+        }
+
+        const auto solution = solve_level(solver, threadCount, maxNodes);
+        if (isSingleLevel) {
+            print_solution(levelName, game, solution);
+            if (solution.isSolved && !replayFilename.empty()) {
+                std::ofstream ofstream{ replayFilename, std::ios::binary };
+                ofstream << SB::SokobanReplay{ solution.moves };
+            }
+            failureCount += solution.isSolved ? 0 : 1;
+            return;
+        }
+
+        // Batch mode: validate the solution and print a single line for each level
+        const auto isValid = solution.isSolved && validate_solution(game, solution);
+        if (!isValid) {
+            ++failureCount;
+        }
+        std::cout << levelName << ": "
+                  << (isValid ? "OK" : solution.isSolved ? "INVALID" : "UNSOLVED") << ", "
+                  << solution.pushes.size() << " pushes, " << solution.moves.size()
+                  << " moves, " << solution.statistics.expandedNodes << " nodes, "
+                  << solution.statistics.elapsedSeconds << " s" << std::endl;
+    };
+
+    for (const auto& levelFilename : levelFilenames) {
+        solveGame(levelFilename, SB::SokobanGame{ levelFilename });
+    }
+
+    // The pack is mapped once, and each level is parsed right before it is solved
+    for (const auto& packFilename : packFilenames) {
+        const SB::SokobanLevelPack levelPack{ packFilename };
+        for (std::size_t i = 0; i < levelPack.size(); ++i) {
+            solveGame(packFilename + " #" + std::to_string(i + 1) + " (" + levelPack.title(i) + ")",
+                      levelPack.load(i));
+        }
+    }
+
+    if (!isScaling && !isSingleLevel) {
+        std::cout << levelCount - failureCount << " of " << levelCount << " levels solved."
+                  << std::endl;
+    }
+
+    return failureCount == 0 ? 0 : 2;
+}
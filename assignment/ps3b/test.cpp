@@ -3,12 +3,28 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE Main
 
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <boost/test/unit_test.hpp>
+#include "FrameProfiler.hpp"
+#include "InvalidCoordinateException.hpp"
+#include "ResourceCache.hpp"
 #include "Sokoban.hpp"
+#include "SokobanGame.hpp"
+#include "SokobanGenerator.hpp"
+#include "SokobanLevelPack.hpp"
+#include "SokobanPathPlanner.hpp"
+#include "SokobanReplay.hpp"
+#include "SokobanScheduler.hpp"
+#include "SokobanSolver.hpp"
 
 /**
  * @brief Checks if two coordinates are the same.
@@ -21,6 +37,33 @@ bool isCoordinateEqual(const sf::Vector2u& first, const sf::Vector2u& second) no
     return first.x == second.x && first.y == second.y;
 }
 
+/**
+ * @brief A file in the temporary directory that a test writes. The file is removed when it goes out
+ * of scope, so a failed check does not leave it behind.
+ */
+class TemporaryFile {
+ public:
+    /**
+     * @brief Creates a temporary file path with a specified name; the file is not created.
+     */
+    explicit TemporaryFile(const std::string& filename)
+        : m_path((std::filesystem::temp_directory_path() / ("ps3b-test-" + filename)).string()) {}
+
+    TemporaryFile(const TemporaryFile&) = delete;
+
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    ~TemporaryFile() { std::remove(m_path.c_str()); }
+
+    /**
+     * @brief Returns the path of the file.
+     */
+    [[nodiscard]] const std::string& path() const { return m_path; }
+
+ private:
+    std::string m_path;
+};
+
 // Tests if `height()` and `width()` returns the height and width of a map correctly.
 BOOST_AUTO_TEST_CASE(testHeightWidth) {
     const SB::Sokoban sokoban{ "assets/level/level2.lvl" };
@@ -181,3 +224,675 @@ BOOST_AUTO_TEST_CASE(testIsWonTooManyStorages) {
 
     BOOST_REQUIRE(sokoban.isWon());
 }
+
+// Tests if `undo()` restores the compact state: the hash of the state after undoing a push should
+// be the same as the hash of the initial state.
+BOOST_AUTO_TEST_CASE(testUndoRestoresState) {
+    SB::Sokoban sokoban{ "assets/level/level2.lvl" };
+    const auto initialState = sokoban.state();
+    sokoban.movePlayer(SB::Direction::Right);
+
+    BOOST_REQUIRE(sokoban.state() != initialState);
+    BOOST_REQUIRE(!sokoban.state().hasBox(9 + 5 * 12));
+
+    sokoban.undo();
+
+    BOOST_REQUIRE(sokoban.state() == initialState);
+    BOOST_REQUIRE_EQUAL(sokoban.state().hash(), initialState.hash());
+    BOOST_REQUIRE(isCoordinateEqual(sokoban.playerLoc(), { 8, 5 }));
+}
+
+// Tests if two states that are reached by different move sequences hash the same.
+BOOST_AUTO_TEST_CASE(testStateHashTransposition) {
+    SB::Sokoban first{ "assets/level/level1.lvl" };
+    first.movePlayer(SB::Direction::Up);
+    first.movePlayer(SB::Direction::Left);
+
+    SB::Sokoban second{ "assets/level/level1.lvl" };
+    second.movePlayer(SB::Direction::Left);
+    second.movePlayer(SB::Direction::Up);
+
+    BOOST_REQUIRE(first.state() == second.state());
+    BOOST_REQUIRE_EQUAL(first.state().hash(), second.state().hash());
+}
+
+// Tests if `redo()` works correctly: a move that has been undone can be redone, and a new move
+// discards the moves that are available to redo.
+BOOST_AUTO_TEST_CASE(testRedo) {
+    SB::Sokoban sokoban{ "assets/level/level2.lvl" };
+    sokoban.movePlayer(SB::Direction::Right);
+    const auto pushedState = sokoban.state();
+    sokoban.undo();
+    sokoban.redo();
+
+    BOOST_REQUIRE(sokoban.state() == pushedState);
+    BOOST_REQUIRE(isCoordinateEqual(sokoban.playerLoc(), { 9, 5 }));
+    BOOST_REQUIRE(sokoban.getTileChar({ 10, 5 }) == SB::TileChar::Box);
+
+    sokoban.undo();
+    sokoban.movePlayer(SB::Direction::Down);
+    sokoban.redo();
+
+    BOOST_REQUIRE(isCoordinateEqual(sokoban.playerLoc(), { 8, 6 }));
+    BOOST_REQUIRE(sokoban.getTileChar({ 9, 5 }) == SB::TileChar::Box);
+}
+
+// Tests if `undo()` and `redo()` keep the score consistent: redoing the moves that push a box
+// should lead to the same victory as making them directly.
+BOOST_AUTO_TEST_CASE(testUndoRedoWin) {
+    SB::Sokoban sokoban{ "assets/level/level5.lvl" };
+    sokoban.movePlayer(SB::Direction::Up);
+    sokoban.movePlayer(SB::Direction::Up);
+    sokoban.movePlayer(SB::Direction::Up);
+    sokoban.movePlayer(SB::Direction::Up);
+    sokoban.movePlayer(SB::Direction::Right);
+    sokoban.movePlayer(SB::Direction::Right);
+    sokoban.movePlayer(SB::Direction::Right);
+    sokoban.movePlayer(SB::Direction::Right);
+    sokoban.movePlayer(SB::Direction::Down);
+    sokoban.movePlayer(SB::Direction::Right);
+    for (int i = 0; i < 6; ++i) {
+        sokoban.undo();
+    }
+    for (int i = 0; i < 6; ++i) {
+        sokoban.redo();
+    }
+    sokoban.movePlayer(SB::Direction::Up);
+
+    BOOST_REQUIRE(sokoban.isWon());
+}
+
+// Tests if `SokobanSolver` finds a solution whose moves win the game when they are replayed.
+BOOST_AUTO_TEST_CASE(testSolverSolvesLevel) {
+    SB::Sokoban sokoban{ "assets/level/level1.lvl" };
+    const SB::SokobanSolver solver{ sokoban.state() };
+    const auto solution = solver.solve();
+
+    BOOST_REQUIRE(solution.isSolved);
+    for (const auto direction : solution.moves) {
+        sokoban.movePlayer(direction);
+    }
+
+    BOOST_REQUIRE(sokoban.isWon());
+}
+
+// Tests if `SokobanSolver` finds the solution with the fewest pushes: in level5, either box needs
+// five pushes to reach the only storage.
+BOOST_AUTO_TEST_CASE(testSolverFewestPushes) {
+    const SB::Sokoban sokoban{ "assets/level/level5.lvl" };
+    const SB::SokobanSolver solver{ sokoban.state() };
+    const auto solution = solver.solve();
+
+    BOOST_REQUIRE(solution.isSolved);
+    BOOST_REQUIRE_EQUAL(solution.pushes.size(), 5);
+    BOOST_REQUIRE_EQUAL(solver.lowerBound(sokoban.state()), 5);
+}
+
+// Tests if the headless game plays a level without any assets, and copies of it are independent.
+BOOST_AUTO_TEST_CASE(testHeadlessGame) {
+    const SB::SokobanGame game{ "assets/level/level1.lvl" };
+    const auto solution = SB::SokobanSolver{ game.state(), game.analysis() }.solve();
+
+    auto copy = game;
+    for (const auto direction : solution.moves) {
+        copy.movePlayer(direction);
+    }
+    BOOST_REQUIRE(copy.isWon());
+    BOOST_REQUIRE_EQUAL(copy.moveCount(), solution.moves.size());
+    BOOST_REQUIRE(!game.isWon());
+    BOOST_REQUIRE_EQUAL(game.moveCount(), 0);
+    BOOST_REQUIRE(game.state() != copy.state());
+}
+
+// Tests if a game written with `operator<<` is read back as the same level.
+BOOST_AUTO_TEST_CASE(testWriteLevel) {
+    SB::SokobanGame game{ "assets/level/level1.lvl" };
+    game.movePlayer(SB::Direction::Up);
+    const TemporaryFile savedFile{ "level1-saved.lvl" };
+    {
+        std::ofstream ofstream{ savedFile.path() };
+        ofstream << game;
+    }
+
+    const SB::SokobanGame savedGame{ savedFile.path() };
+    BOOST_REQUIRE_EQUAL(savedGame.width(), game.width());
+    BOOST_REQUIRE_EQUAL(savedGame.height(), game.height());
+    BOOST_REQUIRE(isCoordinateEqual(savedGame.playerLoc(), game.playerLoc()));
+    BOOST_REQUIRE(savedGame.state() == game.state());
+}
+
+// Tests if the parallel search finds a solution as short as the serial one, and the solution wins.
+BOOST_AUTO_TEST_CASE(testSolverParallel) {
+    const SB::SokobanSolver solver{ SB::Sokoban{ "assets/level/level5.lvl" }.state() };
+    const auto solution = solver.solveParallel(4);
+
+    BOOST_REQUIRE(solution.isSolved);
+    BOOST_REQUIRE_EQUAL(solution.pushes.size(), solver.solve().pushes.size());
+    BOOST_REQUIRE_THROW(static_cast<void>(solver.solveParallel(0)), std::invalid_argument);
+
+    SB::Sokoban sokoban{ "assets/level/level5.lvl" };
+    for (const auto direction : solution.moves) {
+        sokoban.movePlayer(direction);
+    }
+    BOOST_REQUIRE(sokoban.isWon());
+}
+
+// Tests if the level analysis computed on loading gives the push distances and the dead squares.
+BOOST_AUTO_TEST_CASE(testLevelAnalysis) {
+    const SB::Sokoban sokoban{ "assets/level/level1.lvl" };
+    const auto analysis = sokoban.analysis();
+
+    BOOST_REQUIRE_EQUAL(analysis->storages().size(), 2);
+    BOOST_REQUIRE_EQUAL(analysis->nearestDistance(8 + 7 * 10), 0);
+    BOOST_REQUIRE_EQUAL(analysis->nearestDistance(5 + 2 * 10), 1);
+    BOOST_REQUIRE_EQUAL(analysis->distance(0, 5 + 2 * 10), 1);
+    BOOST_REQUIRE(sokoban.isDeadSquare({ 1, 1 }));
+    BOOST_REQUIRE(sokoban.isDeadSquare({ 3, 8 }));
+    BOOST_REQUIRE(!sokoban.isDeadSquare({ 5, 2 }));
+    const sf::Vector2i outsideCoordinate{ 0, 10 };
+    BOOST_REQUIRE_THROW(
+        static_cast<void>(sokoban.isDeadSquare(outsideCoordinate)), SB::InvalidCoordinateException);
+
+    // A solver shares the analysis instead of computing its own
+    const SB::SokobanSolver solver{ sokoban.state(), analysis };
+    BOOST_REQUIRE(solver.solve().isSolved);
+}
+
+// Tests if `SokobanSolver` parks an extra box on a dead square when there are more boxes than
+// storages.
+BOOST_AUTO_TEST_CASE(testSolverExtraBoxOnDeadSquare) {
+    const TemporaryFile levelFile{ "extra-box.lvl" };
+    {
+        std::ofstream ofstream{ levelFile.path() };
+        ofstream << "5 7\n#######\n##.####\n#.A.Aa#\n#@.####\n#######\n";
+    }
+    const SB::SokobanGame game{ levelFile.path() };
+
+    const SB::SokobanSolver solver{ game.state(), game.analysis() };
+    for (const auto& solution : { solver.solve(), solver.solveParallel(2) }) {
+        BOOST_REQUIRE(solution.isSolved);
+        auto copy = game;
+        for (const auto direction : solution.moves) {
+            copy.movePlayer(direction);
+        }
+        BOOST_REQUIRE(copy.isWon());
+    }
+}
+
+// Tests if `SokobanSolver` detects dead squares: a box in a corner can never be moved.
+BOOST_AUTO_TEST_CASE(testSolverDeadSquares) {
+    const SB::Sokoban sokoban{ "assets/level/level1.lvl" };
+    const SB::SokobanSolver solver{ sokoban.state() };
+
+    BOOST_REQUIRE(solver.isDeadSquare(1 + 1 * 10));
+    BOOST_REQUIRE(!solver.isDeadSquare(5 + 2 * 10));
+}
+
+// Tests if `SokobanReplay` encodes runs and mixed moves, and decodes them back in order.
+BOOST_AUTO_TEST_CASE(testReplayEncoding) {
+    using SB::Direction;
+    std::vector<Direction> moves(40, Direction::Right);
+    moves.insert(moves.end(), { Direction::Up, Direction::Left, Direction::Down, Direction::Up });
+    moves.insert(moves.end(), { Direction::Down, Direction::Down, Direction::Down });
+    moves.push_back(Direction::Left);
+
+    const SB::SokobanReplay replay{ moves };
+    BOOST_REQUIRE_EQUAL(replay.moveCount(), moves.size());
+    BOOST_REQUIRE(replay.moves() == moves);
+
+    // Two runs of 32 and 8 rights, then a block of eight literal moves in two bytes
+    BOOST_REQUIRE_EQUAL(replay.data().size(), 5);
+    BOOST_REQUIRE(SB::SokobanReplay{}.moves().empty());
+
+    // Literal moves take two bits each, and a block holds up to 128 of them
+    std::vector<Direction> turns;
+    for (int i = 0; i < 200; ++i) {
+        turns.push_back(i % 2 == 0 ? Direction::Up : Direction::Right);
+    }
+    const SB::SokobanReplay turnReplay{ turns };
+    BOOST_REQUIRE(turnReplay.moves() == turns);
+    BOOST_REQUIRE_EQUAL(turnReplay.data().size(), 1 + 32 + 1 + 18);
+}
+
+// Tests if a replay saved to a file wins the level after it is read back, and a modified replay
+// does not.
+BOOST_AUTO_TEST_CASE(testReplayVerify) {
+    SB::SokobanGame game{ "assets/level/level1.lvl" };
+    const auto solution = SB::SokobanSolver{ game.state(), game.analysis() }.solve();
+    for (const auto direction : solution.moves) {
+        game.movePlayer(direction);
+    }
+    const TemporaryFile replayFile{ "level1.sbr" };
+    {
+        std::ofstream ofstream{ replayFile.path(), std::ios::binary };
+        ofstream << game.replay();
+    }
+
+    SB::SokobanReplay replay;
+    std::ifstream ifstream{ replayFile.path(), std::ios::binary };
+    ifstream >> replay;
+
+    const SB::SokobanGame initialGame{ "assets/level/level1.lvl" };
+    BOOST_REQUIRE(replay.moves() == solution.moves);
+    BOOST_REQUIRE(replay.verify(initialGame));
+    BOOST_REQUIRE(replay.verify(initialGame));
+
+    auto moves = replay.moves();
+    moves.pop_back();
+    BOOST_REQUIRE(!SB::SokobanReplay{ moves }.verify(initialGame));
+
+    // A block of five literal moves needs two bytes after its header
+    {
+        std::ofstream ofstream{ replayFile.path(), std::ios::binary };
+        ofstream << SB::SokobanReplay::MAGIC;
+        ofstream.write("\x05\0\0\0\x04\x1b", 6);
+    }
+    std::ifstream truncatedIfstream{ replayFile.path(), std::ios::binary };
+    BOOST_REQUIRE_THROW(truncatedIfstream >> replay, std::invalid_argument);
+}
+
+// Tests if `SokobanGenerator` generates solvable levels in the band, and the levels do not depend
+// on the number of threads.
+BOOST_AUTO_TEST_CASE(testGenerator) {
+    const SB::SokobanGenerator generator{ 8, 8, 2 };
+    SB::DifficultyBand band;
+    band.minPushes = 4;
+    band.maxPushes = 30;
+
+    const auto levels = generator.generate(3, band, 1, 1, 1000);
+    BOOST_REQUIRE_EQUAL(levels.size(), 3);
+    const TemporaryFile levelFile{ "generated.lvl" };
+    for (const auto& level : levels) {
+        BOOST_REQUIRE(SB::SokobanGenerator::isInBand(level, band));
+
+        // The level can be written and solved after it is read back
+        {
+            std::ofstream ofstream{ levelFile.path() };
+            ofstream << level.game;
+        }
+        const SB::SokobanGame game{ levelFile.path() };
+        const auto solution = SB::SokobanSolver{ game.state(), game.analysis() }.solve();
+        BOOST_REQUIRE_EQUAL(solution.pushes.size(), level.pushes);
+    }
+
+    const auto parallelLevels = generator.generate(3, band, 3, 1, 1000);
+    BOOST_REQUIRE_EQUAL(parallelLevels.size(), 3);
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(parallelLevels[i].seed, levels[i].seed);
+        BOOST_REQUIRE(parallelLevels[i].game.state() == levels[i].game.state());
+    }
+
+    // A candidate may leave the player in a storage, which is written as '+' and read back
+    const auto candidate = generator.generateCandidate(17);
+    const auto playerLoc = candidate.game.playerLoc();
+    const sf::Vector2i playerCoordinate{ static_cast<int>(playerLoc.x),
+                                         static_cast<int>(playerLoc.y) };
+    BOOST_REQUIRE(candidate.isSolved);
+    BOOST_REQUIRE(candidate.game.getTileChar(playerCoordinate) == SB::TileChar::Storage);
+    const TemporaryFile candidateFile{ "candidate.lvl" };
+    {
+        std::ofstream ofstream{ candidateFile.path() };
+        ofstream << candidate.game;
+    }
+    std::ifstream ifstream{ candidateFile.path() };
+    const std::string text{ std::istreambuf_iterator<char>{ ifstream }, {} };
+    BOOST_REQUIRE_NE(text.find('+'), std::string::npos);
+    BOOST_REQUIRE(SB::SokobanGame{ candidateFile.path() }.state() == candidate.game.state());
+
+    BOOST_REQUIRE_THROW(SB::SokobanGenerator(3, 3, 1), std::invalid_argument);
+}
+
+// Tests if a large map is drawn through a camera that follows the player, and only the chunks of
+// the tile layer in the view are built.
+BOOST_AUTO_TEST_CASE(testLargeMapCamera) {
+    constexpr int width = 100;
+    constexpr int height = 70;
+    std::vector<SB::TileChar> tileCharGrid(width * height, SB::TileChar::Empty);
+    tileCharGrid[50 + 35 * width] = SB::TileChar::Player;
+    tileCharGrid[52 + 35 * width] = SB::TileChar::Box;
+    tileCharGrid[60 + 35 * width] = SB::TileChar::Storage;
+    SB::Sokoban sokoban;
+    sokoban.load(SB::SokobanGame{ width, height, tileCharGrid });
+
+    // The player is in the center of the view
+    const sf::Vector2u targetSize{ 640, 480 };
+    const auto view = sokoban.cameraView(targetSize);
+    BOOST_REQUIRE_EQUAL(view.getCenter().x, 50.5f * SB::TILE_WIDTH);
+    BOOST_REQUIRE_EQUAL(view.getCenter().y, 35.5f * SB::TILE_HEIGHT);
+
+    // The view never goes past the map, and a small map is centered
+    for (int i = 0; i < 48; ++i) {
+        sokoban.movePlayer(SB::Direction::Left);
+    }
+    BOOST_REQUIRE_EQUAL(sokoban.cameraView(targetSize).getCenter().x, 320.0f);
+    const SB::Sokoban smallSokoban{ "assets/level/level1.lvl" };
+    BOOST_REQUIRE_EQUAL(smallSokoban.cameraView(targetSize * 2u).getCenter().x, 320.0f);
+
+    // The view covers one column and two rows of chunks
+    sf::RenderTexture renderTexture;
+    renderTexture.create(targetSize.x, targetSize.y);
+    sokoban.reset();
+    renderTexture.draw(sokoban);
+    BOOST_REQUIRE_EQUAL(sokoban.builtChunkCount(), 2);
+}
+
+// Tests if the player and the boxes stay inside a map that is not surrounded by walls, and the
+// checked API rejects the coordinates outside the map.
+BOOST_AUTO_TEST_CASE(testMapEdges) {
+    using SB::TileChar;
+    SB::SokobanGame game{ 3, 2, { TileChar::Player, TileChar::Box, TileChar::Empty,
+                                  TileChar::Empty, TileChar::Empty, TileChar::Storage } };
+    game.movePlayer(SB::Direction::Left);
+    game.movePlayer(SB::Direction::Up);
+    BOOST_REQUIRE(isCoordinateEqual(game.playerLoc(), { 0, 0 }));
+    BOOST_REQUIRE_EQUAL(game.moveCount(), 0);
+
+    // The box is pushed to the right edge, and cannot be pushed any further
+    game.movePlayer(SB::Direction::Right);
+    game.movePlayer(SB::Direction::Right);
+    BOOST_REQUIRE(isCoordinateEqual(game.playerLoc(), { 1, 0 }));
+    BOOST_REQUIRE(game.getTileChar({ 2, 0 }) == TileChar::Box);
+
+    // The player walks around the box onto the storage below it
+    game.movePlayer(SB::Direction::Down);
+    game.movePlayer(SB::Direction::Right);
+    game.movePlayer(SB::Direction::Right);
+    game.undo();
+    game.redo();
+    BOOST_REQUIRE(isCoordinateEqual(game.playerLoc(), { 2, 1 }));
+    BOOST_REQUIRE_EQUAL(game.moveCount(), 3);
+    BOOST_REQUIRE(!game.isWon());
+
+    const sf::Vector2i rightOfMap{ 3, 0 };
+    const sf::Vector2i leftOfMap{ -1, 1 };
+    BOOST_REQUIRE_THROW(static_cast<void>(game.getTileChar(rightOfMap)),
+                        SB::InvalidCoordinateException);
+    BOOST_REQUIRE_THROW(static_cast<void>(game.getTileChar(leftOfMap)),
+                        SB::InvalidCoordinateException);
+}
+
+// Tests if `SokobanReachability` finds the region of the player, and two states that differ only
+// by the player location within the region are normalized to the same state.
+BOOST_AUTO_TEST_CASE(testReachability) {
+    using SB::TileChar;
+    // A wall splits the map; the box closes the gap between the halves
+    SB::SokobanGame game{ 5, 3, { TileChar::Empty, TileChar::Empty, TileChar::Wall, TileChar::Empty,
+                                  TileChar::Storage,
+                                  TileChar::Empty, TileChar::Player, TileChar::Box,
+                                  TileChar::Empty, TileChar::Empty,
+                                  TileChar::Empty, TileChar::Empty, TileChar::Wall,
+                                  TileChar::Empty, TileChar::Empty } };
+    BOOST_REQUIRE_EQUAL(game.reachability().region().size(), 6);
+    BOOST_REQUIRE_EQUAL(game.reachability().canonicalPlayerIndex(), 0);
+    BOOST_REQUIRE(game.isReachable({ 0, 2 }));
+    BOOST_REQUIRE(!game.isReachable({ 3, 1 }));
+
+    // The region is updated after the box is pushed into the other half
+    game.movePlayer(SB::Direction::Right);
+    BOOST_REQUIRE(game.isReachable({ 2, 1 }));
+    BOOST_REQUIRE(!game.isReachable({ 3, 1 }));
+    BOOST_REQUIRE(!game.isReachable({ 4, 1 }));
+    BOOST_REQUIRE_EQUAL(game.reachability().region().size(), 7);
+
+    // Nothing is reachable before the first computation
+    SB::SokobanReachability reachability;
+    BOOST_REQUIRE(!reachability.isReachable(0));
+    auto other = game;
+    other.movePlayer(SB::Direction::Left);
+    BOOST_REQUIRE(game.state() != other.state());
+    BOOST_REQUIRE(reachability.normalize(game.state()) == reachability.normalize(other.state()));
+    BOOST_REQUIRE_EQUAL(reachability.canonicalPlayerIndex(), 0);
+    BOOST_REQUIRE(!reachability.isReachable(-1));
+    BOOST_REQUIRE(!reachability.isReachable(15));
+}
+
+// Tests if the planner finds the shortest walks and the fewest pushes, and reports the targets that
+// cannot be reached.
+BOOST_AUTO_TEST_CASE(testPathPlanner) {
+    using SB::TileChar;
+    SB::SokobanGame game{ 5, 3, { TileChar::Empty, TileChar::Empty, TileChar::Wall, TileChar::Empty,
+                                  TileChar::Storage,
+                                  TileChar::Empty, TileChar::Player, TileChar::Box,
+                                  TileChar::Empty, TileChar::Empty,
+                                  TileChar::Empty, TileChar::Empty, TileChar::Wall,
+                                  TileChar::Empty, TileChar::Empty } };
+    constexpr int64_t budget = 1000000;
+
+    // The shortest walk to a tile
+    SB::SokobanPathPlanner planner;
+    planner.planWalk(game, { 0, 2 });
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Found);
+    BOOST_REQUIRE_EQUAL(planner.path().size(), 2);
+    auto walked = game;
+    for (const auto direction : planner.path()) {
+        walked.movePlayer(direction);
+    }
+    BOOST_REQUIRE(isCoordinateEqual(walked.playerLoc(), { 0, 2 }));
+
+    // The other half can only be reached by pushing the box; walls and boxes are never reached
+    planner.planWalk(game, { 3, 1 });
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Unreachable);
+    planner.planWalk(game, { 2, 0 });
+    BOOST_REQUIRE(planner.status() == SB::PlanStatus::Unreachable);
+    BOOST_REQUIRE_THROW(planner.planWalk(game, { 5, 0 }), SB::InvalidCoordinateException);
+    planner.cancel();
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Idle);
+
+    // Push the box into the storage: two pushes to the right, a walk around and a push up
+    planner.planPush(game, { 2, 1 }, { 4, 0 });
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Found);
+    BOOST_REQUIRE_EQUAL(planner.path().size(), 5);
+    for (const auto direction : planner.path()) {
+        game.movePlayer(direction);
+    }
+    BOOST_REQUIRE(game.isWon());
+
+    // A box in a corner cannot be pushed anywhere
+    planner.planPush(game, { 4, 0 }, { 3, 0 });
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Unreachable);
+}
+
+// Tests if an advance on a large open map stops at its time budget, measured with a clock that
+// moves forward on each read, and the pushes and the walks between them are found over several
+// advances.
+BOOST_AUTO_TEST_CASE(testPathPlannerBudget) {
+    constexpr int width = 300;
+    constexpr int height = 300;
+    std::vector<SB::TileChar> tileCharGrid(width * height, SB::TileChar::Empty);
+    tileCharGrid[1 + 150 * width] = SB::TileChar::Player;
+    tileCharGrid[150 + 150 * width] = SB::TileChar::Box;
+    tileCharGrid[290 + 20 * width] = SB::TileChar::Storage;
+    SB::SokobanGame game{ width, height, tileCharGrid };
+
+    // Each read of the clock takes a millisecond, so the budget lasts for three reads
+    int64_t now = 0;
+    SB::SokobanPathPlanner planner{ [&now] { return now += 1000; } };
+    constexpr int64_t budget = 2500;
+
+    // The clock is read after each push node, and after every 256 tiles of a walk
+    planner.planPush(game, { 150, 150 }, { 290, 20 });
+    BOOST_REQUIRE(planner.advance(budget) == SB::PlanStatus::Searching);
+    BOOST_REQUIRE_EQUAL(planner.expansionCount(), 3);
+    auto advanceCount = 1;
+    for (auto expansionCount = planner.expansionCount();
+         planner.advance(budget) == SB::PlanStatus::Searching;
+         expansionCount = planner.expansionCount()) {
+        BOOST_REQUIRE_LE(planner.expansionCount() - expansionCount, 3 * 256);
+        ++advanceCount;
+    }
+    BOOST_REQUIRE_GT(advanceCount, 1000);
+
+    BOOST_REQUIRE(planner.status() == SB::PlanStatus::Found);
+    for (const auto direction : planner.path()) {
+        game.movePlayer(direction);
+    }
+    BOOST_REQUIRE(game.isWon());
+}
+
+// Tests if a level pack is indexed into its levels and titles, and a level is parsed into a game
+// with the outside of the walls filled, including a player in a storage.
+BOOST_AUTO_TEST_CASE(testLevelPack) {
+    const TemporaryFile packFile{ "pack.txt" };
+    {
+        std::ofstream ofstream{ packFile.path() };
+        ofstream << "; A pack of two levels\n"
+                 << "\n"
+                 << "; First\n"
+                 << "#####\n"
+                 << "#@$.#\n"
+                 << "#####\n"
+                 << "\n"
+                 << "  ####\r\n"
+                 << "###+ #\r\n"
+                 << "#  $ #\r\n"
+                 << "######\r\n"
+                 << "Title: Second\n";
+    }
+
+    const SB::SokobanLevelPack levelPack{ packFile.path() };
+    BOOST_REQUIRE_EQUAL(levelPack.size(), 2);
+    BOOST_REQUIRE_EQUAL(levelPack.title(0), "First");
+    BOOST_REQUIRE_EQUAL(levelPack.title(1), "Second");
+    BOOST_REQUIRE_THROW(static_cast<void>(levelPack.load(2)), std::out_of_range);
+
+    auto first = levelPack.load(0);
+    BOOST_REQUIRE_EQUAL(first.width(), 5);
+    BOOST_REQUIRE_EQUAL(first.height(), 3);
+    first.movePlayer(SB::Direction::Right);
+    BOOST_REQUIRE(first.isWon());
+
+    // The spaces outside the walls become walls; the storage under the player is kept
+    SB::SokobanGame second;
+    second.load(levelPack.load(1));
+    BOOST_REQUIRE_EQUAL(second.width(), 6);
+    BOOST_REQUIRE_EQUAL(second.height(), 4);
+    BOOST_REQUIRE(second.getTileChar({ 0, 0 }) == SB::TileChar::Wall);
+    BOOST_REQUIRE(second.getTileChar({ 3, 1 }) == SB::TileChar::Storage);
+    BOOST_REQUIRE(isCoordinateEqual(second.playerLoc(), { 3, 1 }));
+    BOOST_REQUIRE_EQUAL(second.maxScore(), 1);
+    BOOST_REQUIRE(second.getTileChar({ 1, 0 }) == SB::TileChar::Wall);
+    BOOST_REQUIRE(second.getTileChar({ 1, 2 }) == SB::TileChar::Empty);
+}
+
+// Tests if the frame profiler records the draw calls and allocations of each frame in a window of
+// recent frames, and writes every frame to the trace
+BOOST_AUTO_TEST_CASE(testFrameProfiler) {
+    BOOST_REQUIRE_THROW(FP::FrameProfiler{ 0 }, std::invalid_argument);
+
+    FP::FrameProfiler profiler{ 4 };
+    BOOST_REQUIRE_EQUAL(profiler.percentiles(FP::Metric::Frame).max, 0.0);
+    const TemporaryFile traceFile{ "trace.csv" };
+    profiler.startTrace(traceFile.path());
+    BOOST_REQUIRE(profiler.isTracing());
+    for (int frame = 0; frame < 6; ++frame) {
+        profiler.beginFrame();
+        profiler.beginSection(FP::Section::Update);
+        const auto value = std::make_unique<int>(frame);
+        profiler.endSection(FP::Section::Update);
+        profiler.beginSection(FP::Section::Draw);
+        for (int i = 0; i < frame; ++i) {
+            FP::countDrawCall();
+        }
+        profiler.endSection(FP::Section::Draw);
+        profiler.endFrame();
+    }
+    profiler.stopTrace();
+
+    // The ring keeps the last four frames
+    BOOST_REQUIRE_EQUAL(profiler.frameCount(), 6);
+    const auto& lastFrame = profiler.lastFrame();
+    BOOST_REQUIRE_EQUAL(lastFrame.index, 5);
+    BOOST_REQUIRE_EQUAL(lastFrame.drawCalls, 5);
+    BOOST_REQUIRE_EQUAL(lastFrame.allocations, 1);
+    BOOST_REQUIRE_GE(lastFrame.frameMilliseconds,
+                     lastFrame.updateMilliseconds + lastFrame.drawMilliseconds);
+
+    const auto percentiles = profiler.percentiles(FP::Metric::Frame);
+    BOOST_REQUIRE_LE(percentiles.p50, percentiles.p95);
+    BOOST_REQUIRE_LE(percentiles.p95, percentiles.p99);
+    BOOST_REQUIRE_LE(percentiles.p99, percentiles.max);
+
+    // A header line and a line for each frame
+    std::ifstream trace{ traceFile.path() };
+    std::string line;
+    auto lineCount = 0;
+    while (std::getline(trace, line)) {
+        ++lineCount;
+    }
+    BOOST_REQUIRE_EQUAL(lineCount, 7);
+}
+
+// Tests if the scheduler applies the queued commands in order at the next fixed step, runs the
+// steps that the elapsed time covers, and the player is drawn between the last two steps.
+BOOST_AUTO_TEST_CASE(testScheduler) {
+    BOOST_REQUIRE_THROW(SB::SokobanScheduler{ 0 }, std::invalid_argument);
+
+    // Without a window, the steps run right away
+    SB::SokobanGame game{ "assets/level/level1.lvl" };
+    SB::SokobanScheduler headless{ 10000 };
+    headless.push({ SB::CommandType::Move, SB::Direction::Right });
+    headless.push({ SB::CommandType::Move, SB::Direction::Right });
+    headless.push({ SB::CommandType::Undo });
+    headless.runSteps(game, 1000);
+    BOOST_REQUIRE_EQUAL(headless.pendingCommandCount(), 0);
+    BOOST_REQUIRE_EQUAL(headless.stepCount(), 1000);
+    BOOST_REQUIRE_EQUAL(game.moveCount(), 1);
+    BOOST_REQUIRE_EQUAL(game.elapsedTime(), 10000000);
+
+    constexpr int width = 100;
+    constexpr int height = 70;
+    std::vector<SB::TileChar> tileCharGrid(width * height, SB::TileChar::Empty);
+    tileCharGrid[50 + 35 * width] = SB::TileChar::Player;
+    tileCharGrid[60 + 35 * width] = SB::TileChar::Box;
+    tileCharGrid[70 + 35 * width] = SB::TileChar::Storage;
+    SB::Sokoban sokoban;
+    sokoban.load(SB::SokobanGame{ width, height, tileCharGrid });
+
+    // A command waits for the next step
+    SB::SokobanScheduler scheduler{ 10000 };
+    BOOST_REQUIRE_EQUAL(scheduler.advance(sokoban, 10000), 1);
+    scheduler.push({ SB::CommandType::Move, SB::Direction::Left });
+    BOOST_REQUIRE_EQUAL(scheduler.advance(sokoban, 5000), 0);
+    BOOST_REQUIRE_EQUAL(scheduler.pendingCommandCount(), 1);
+    BOOST_REQUIRE_EQUAL(sokoban.playerLoc().x, 50);
+    BOOST_REQUIRE_EQUAL(scheduler.advance(sokoban, 7500), 1);
+    BOOST_REQUIRE_EQUAL(sokoban.playerLoc().x, 49);
+    BOOST_REQUIRE_EQUAL(sokoban.elapsedTime(), 20000);
+
+    // The player is drawn a quarter of the way from the previous tile, and the camera follows
+    const sf::Vector2u targetSize{ 640, 480 };
+    BOOST_REQUIRE_CLOSE(scheduler.interpolation(), 0.25f, 1e-3f);
+    sokoban.setInterpolation(scheduler.interpolation());
+    const auto center = sokoban.cameraView(targetSize).getCenter();
+    BOOST_REQUIRE_CLOSE(center.x, 50.25f * SB::TILE_WIDTH, 1e-3f);
+
+    // A long stall runs a limited number of steps, and the rest of the time is dropped
+    BOOST_REQUIRE_EQUAL(
+        scheduler.advance(sokoban, 1000000), SB::SokobanScheduler::MAX_STEPS_PER_FRAME);
+    BOOST_REQUIRE_LT(scheduler.interpolation(), 1.0f);
+}
+
+// Tests if the resource cache loads a file once while it is in use, waits for a prefetched file,
+// and loads a file again after all its users are gone.
+BOOST_AUTO_TEST_CASE(testResourceCache) {
+    RC::ResourceCache cache;
+    auto texture = cache.texture(SB::TILE_GROUND_01_FILENAME);
+    BOOST_REQUIRE_EQUAL(cache.texture(SB::TILE_GROUND_01_FILENAME), texture);
+    BOOST_REQUIRE_EQUAL(cache.font(SB::FONT_DIGITAL7_FILENAME),
+                        cache.font(SB::FONT_DIGITAL7_FILENAME));
+    BOOST_REQUIRE_EQUAL(cache.loadCount(), 2);
+
+    // A prefetched file is read once, however many times it is prefetched; a file in use is not
+    cache.prefetchImages({ SB::TILE_GROUND_01_FILENAME, SB::TILE_BLOCK_06_FILENAME });
+    cache.prefetchImages({ SB::TILE_BLOCK_06_FILENAME });
+    cache.prefetchSoundBuffers({ SB::SOUND_WIN });
+    BOOST_REQUIRE_EQUAL(cache.loadCount(), 4);
+    const auto wall = cache.texture(SB::TILE_BLOCK_06_FILENAME);
+    const auto soundBuffer = cache.soundBuffer(SB::SOUND_WIN);
+    BOOST_REQUIRE_EQUAL(cache.soundBuffer(SB::SOUND_WIN), soundBuffer);
+    BOOST_REQUIRE_EQUAL(cache.loadCount(), 4);
+
+    texture.reset();
+    static_cast<void>(cache.texture(SB::TILE_GROUND_01_FILENAME));
+    BOOST_REQUIRE_EQUAL(cache.loadCount(), 5);
+}
@@ -0,0 +1,81 @@
+// Copyright 2024 James Chen
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SokobanGame.hpp"
+#include "SokobanReplay.hpp"
+
+/**
+ * @brief Verifies replays against a level without rendering, and prints whether each replay wins
+ * the level. The level is loaded once and every replay is played on a copy of it.
+ * @param size The size of the argument list.
+ * @param arguments The command line arguments. This program requires the filename of the level
+ * file, followed by the filenames of the replay files (.sbr) to verify.
+ * @return 0 if all replays win the level; 2 otherwise.
+ */
+int main(const int size, const char* arguments[]) {
+    // Check arguments
+    if (size < 3) {
+        std::cout << "Too few arguments! Require the filename of the level file and the replay "
+                     "files."
+                  << std::endl;
+        return 1;
+    }
+
+    const SB::SokobanGame game{ arguments[1] };
+
+    // Read all replays first, so that only the verification is timed
+    std::vector<std::string> replayFilenames;
+    std::vector<SB::SokobanReplay> replays;
+    auto failureCount = 0;
+    for (int i = 2; i < size; ++i) {
+        const std::string replayFilename{ arguments[i] };
+        std::ifstream ifstream{ replayFilename, std::ios::binary };
+        if (!ifstream.is_open()) {
+            std::cout << replayFilename << ": FAILED, file not found" << std::endl;
+            ++failureCount;
+            continue;
+        }
+
+        SB::SokobanReplay replay;
+        try {
+            ifstream >> replay;
+        } catch (const std::invalid_argument& exception) {
+            std::cout << replayFilename << ": FAILED, " << exception.what() << std::endl;
+            ++failureCount;
+            continue;
+        }
+
+        replayFilenames.push_back(replayFilename);
+        replays.push_back(std::move(replay));
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<bool> results;
+    results.reserve(replays.size());
+    for (const auto& replay : replays) {
+        results.push_back(replay.verify(game));
+    }
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    for (std::size_t i = 0; i < replays.size(); ++i) {
+        if (!results[i]) {
+            ++failureCount;
+        }
+        std::cout << replayFilenames[i] << ": " << (results[i] ? "OK" : "FAILED") << ", "
+                  << replays[i].moveCount() << " moves" << std::endl;
+    }
+
+    const auto replaysPerSecond = elapsedTime.count() > 0.0
+                                      ? static_cast<double>(replays.size()) / elapsedTime.count()
+                                      : 0.0;
+    std::cout << size - 2 - failureCount << " of " << size - 2 << " replays verified in "
+              << elapsedTime.count() << " s (" << replaysPerSecond << " replays/s)." << std::endl;
+
+    return failureCount == 0 ? 0 : 2;
+}
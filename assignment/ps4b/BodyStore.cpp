@@ -0,0 +1,43 @@
+// Copyright 2024 James Chen
+
+#include "BodyStore.hpp"
+
+namespace NB {
+
+std::size_t BodyStore::size() const { return mass.size(); }
+
+void BodyStore::reserve(const std::size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    mass.reserve(count);
+    ax.reserve(count);
+    ay.reserve(count);
+}
+
+std::size_t BodyStore::add(
+    const sf::Vector2<double>& position, const sf::Vector2<double>& velocity,
+    const double bodyMass) {
+    x.push_back(position.x);
+    y.push_back(position.y);
+    vx.push_back(velocity.x);
+    vy.push_back(velocity.y);
+    mass.push_back(bodyMass);
+    ax.push_back(0.0);
+    ay.push_back(0.0);
+
+    return mass.size() - 1;
+}
+
+void BodyStore::clear() {
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    mass.clear();
+    ax.clear();
+    ay.clear();
+}
+
+}  // namespace NB
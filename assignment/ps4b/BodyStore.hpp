@@ -0,0 +1,77 @@
+// Copyright 2024 James Chen
+
+#ifndef BODYSTORE_HPP
+#define BODYSTORE_HPP
+
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+namespace NB {
+
+/**
+ * @brief The state of the bodies of a universe in the structure-of-arrays layout: each quantity of
+ * all bodies is stored contiguously, so the integrator reads the arrays directly instead of going
+ * through a pointer for each body, and the loops over them can be vectorized.
+ */
+struct BodyStore {
+    /**
+     * @brief The x components of the positions.
+     */
+    std::vector<double> x;
+
+    /**
+     * @brief The y components of the positions.
+     */
+    std::vector<double> y;
+
+    /**
+     * @brief The x components of the velocities.
+     */
+    std::vector<double> vx;
+
+    /**
+     * @brief The y components of the velocities.
+     */
+    std::vector<double> vy;
+
+    /**
+     * @brief The masses.
+     */
+    std::vector<double> mass;
+
+    /**
+     * @brief The x components of the accelerations, which the force kernels write.
+     */
+    std::vector<double> ax;
+
+    /**
+     * @brief The y components of the accelerations, which the force kernels write.
+     */
+    std::vector<double> ay;
+
+    /**
+     * @brief Returns the number of bodies.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Reserves the memory for a number of bodies.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Adds a body to the end.
+     * @return The index of the body.
+     */
+    std::size_t add(const sf::Vector2<double>& position, const sf::Vector2<double>& velocity,
+                    double bodyMass);
+
+    /**
+     * @brief Removes all bodies.
+     */
+    void clear();
+};
+
+}  // namespace NB
+
+#endif
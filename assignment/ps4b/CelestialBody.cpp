@@ -4,50 +4,89 @@
 #include <iostream>
 #include <sstream>
 #include <boost/algorithm/string.hpp>
+#include "FrameProfiler.hpp"
 #include "NBodyConstant.hpp"
+#include "ResourceCache.hpp"
 
 namespace NB {
 
 CelestialBody::CelestialBody() : m_universePtr(nullptr) {}
 
-CelestialBody::CelestialBody(Universe* universePtr) :
-    m_universePtr(universePtr) {}
+void CelestialBody::attach(Universe* universePtr) {
+    m_universePtr = universePtr;
+    m_index = universePtr->bodies().add(m_position, m_velocity, m_mass);
+}
 
 sf::Vector2f CelestialBody::position() const {
+    const auto position = positionDouble();
     return {
-        static_cast<float>(m_position.x),
-        static_cast<float>(m_position.y),
+        static_cast<float>(position.x),
+        static_cast<float>(position.y),
     };
 }
 
 sf::Vector2f CelestialBody::velocity() const {
+    const auto velocity = velocityDouble();
     return {
-        static_cast<float>(m_velocity.x),
-        static_cast<float>(m_velocity.y),
+        static_cast<float>(velocity.x),
+        static_cast<float>(velocity.y),
     };
 }
 
-float CelestialBody::mass() const { return static_cast<float>(m_mass); }
+float CelestialBody::mass() const { return static_cast<float>(massDouble()); }
+
+sf::Vector2<double> CelestialBody::positionDouble() const {
+    if (m_universePtr == nullptr) {
+        return m_position;
+    }
+
+    const auto& bodies = m_universePtr->bodies();
+    return { bodies.x[m_index], bodies.y[m_index] };
+}
 
-sf::Vector2<double> CelestialBody::positionDouble() const { return m_position; }
+sf::Vector2<double> CelestialBody::velocityDouble() const {
+    if (m_universePtr == nullptr) {
+        return m_velocity;
+    }
 
-sf::Vector2<double> CelestialBody::velocityDouble() const { return m_velocity; }
+    const auto& bodies = m_universePtr->bodies();
+    return { bodies.vx[m_index], bodies.vy[m_index] };
+}
 
-double CelestialBody::massDouble() const { return m_mass; }
+double CelestialBody::massDouble() const {
+    return m_universePtr == nullptr ? m_mass : m_universePtr->bodies().mass[m_index];
+}
 
 void CelestialBody::position(const sf::Vector2<double> newPosition) {
-    m_position = newPosition;
+    if (m_universePtr == nullptr) {
+        m_position = newPosition;
+        return;
+    }
+
+    auto& bodies = m_universePtr->bodies();
+    bodies.x[m_index] = newPosition.x;
+    bodies.y[m_index] = newPosition.y;
 }
 
 void CelestialBody::velocity(const sf::Vector2<double> newVelocity) {
-    m_velocity = newVelocity;
+    if (m_universePtr == nullptr) {
+        m_velocity = newVelocity;
+        return;
+    }
+
+    auto& bodies = m_universePtr->bodies();
+    bodies.vx[m_index] = newVelocity.x;
+    bodies.vy[m_index] = newVelocity.y;
+}
+
+std::string CelestialBody::imagePath() const {
+    return (ASSETS_IMAGE_DIR / m_image_filename).string();
 }
 
 void CelestialBody::loadResources() {
     // Load the image file
-    m_image.first = std::make_shared<sf::Texture>();
+    m_image.first = RC::ResourceCache::shared().texture(imagePath());
     m_image.second = std::make_shared<sf::Sprite>();
-    m_image.first->loadFromFile(ASSETS_IMAGE_DIR / m_image_filename);
     m_image.second->setTexture(*m_image.first);
 }
 
@@ -61,15 +100,17 @@ void CelestialBody::draw(
     const auto universeScale = m_universePtr->scale();
     const auto imageSprite = m_image.second;
 
+    const auto position = positionDouble();
     const sf::Vector2f realPosition{
         static_cast<float>(
-            (universeRadius + this->m_position.x) / universeScale),
+            (universeRadius + position.x) / universeScale),
         static_cast<float>(
-            (universeRadius - this->m_position.y) / universeScale),
+            (universeRadius - position.y) / universeScale),
     };
     imageSprite->setPosition(realPosition);
 
     target.draw(*imageSprite, states);
+    FP::countDrawCall();
 }
 
 std::istream& operator>>(std::istream& istream, CelestialBody& celestialBody) {
@@ -13,6 +13,11 @@ namespace NB {
 
 class Universe;
 
+/**
+ * @brief A celestial body read from a universe file. A body on its own keeps its position,
+ * velocity and mass; once it is attached to a Universe, they are moved into the body store of the
+ * universe, and this class becomes a view of them for drawing and I/O.
+ */
 class CelestialBody final : public sf::Drawable {
  public:
     /**
@@ -21,10 +26,11 @@ class CelestialBody final : public sf::Drawable {
     CelestialBody();
 
     /**
-     * @brief Constructs a CelestialBody instance within a specified Universe.
+     * @brief Moves the position, velocity and mass of this CelestialBody to the end of the body
+     * store of a Universe, and makes this CelestialBody a view of them.
      * @param universePtr Pointer to the Universe this CelestialBody belongs to.
      */
-    explicit CelestialBody(Universe* universePtr);
+    void attach(Universe* universePtr);
 
     /**
      * @brief Retrieves the Universe this CelestialBody belongs to.
@@ -79,7 +85,13 @@ class CelestialBody final : public sf::Drawable {
     void velocity(sf::Vector2<double> newVelocity);
 
     /**
-     * @brief Loads the resource (image) associated with this CelestialBody.
+     * @brief Returns the path of the image of this CelestialBody.
+     */
+    [[nodiscard]] std::string imagePath() const;
+
+    /**
+     * @brief Loads the resource (image) associated with this CelestialBody. The texture is shared
+     * with the other bodies of the same image.
      */
     void loadResources();
 
@@ -98,17 +110,22 @@ class CelestialBody final : public sf::Drawable {
     Universe* m_universePtr;
 
     /**
-     * @brief The center coordinate of this CelestialBody.
+     * @brief The index of this CelestialBody in the body store of the Universe.
+     */
+    std::size_t m_index = 0;
+
+    /**
+     * @brief The center coordinate of this CelestialBody before it is attached to a Universe.
      */
     sf::Vector2<double> m_position;
 
     /**
-     * @brief The velocity vector of this CelestialBody.
+     * @brief The velocity vector of this CelestialBody before it is attached to a Universe.
      */
     sf::Vector2<double> m_velocity;
 
     /**
-     * @brief The mass of this CelestialBody.
+     * @brief The mass of this CelestialBody before it is attached to a Universe.
      */
     double m_mass = 0.0;
 
@@ -120,7 +137,7 @@ class CelestialBody final : public sf::Drawable {
     /**
      * @brief Pair containing shared pointers to the texture and sprite of this CelestialBody.
      */
-    std::pair<std::shared_ptr<sf::Texture>, std::shared_ptr<sf::Sprite>> m_image;
+    std::pair<std::shared_ptr<const sf::Texture>, std::shared_ptr<sf::Sprite>> m_image;
 
     /**
      * @brief Reads data from a std::istream into the CelestialBody.
@@ -0,0 +1,263 @@
+// Copyright 2024 James Chen
+
+#include "GravityKernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include "NBodyConstant.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NB_HAS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Returns the sum of m_j * (p_j - p_i) / |p_j - p_i|^3 over the bodies j in [first, last),
+ * skipping the bodies at the position of body i; the sum is added to sumX and sumY.
+ */
+void accumulate_row_scalar(
+    const NB::BodyStore& bodies, const std::size_t i, const std::size_t first,
+    const std::size_t last, double& sumX, double& sumY) {
+    const auto xi = bodies.x[i];
+    const auto yi = bodies.y[i];
+    for (std::size_t j = first; j < last; ++j) {
+        const auto dx = bodies.x[j] - xi;
+        const auto dy = bodies.y[j] - yi;
+        const auto distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared == 0.0) {
+            continue;
+        }
+
+        const auto scale = bodies.mass[j] / (distanceSquared * std::sqrt(distanceSquared));
+        sumX += scale * dx;
+        sumY += scale * dy;
+    }
+}
+
+/**
+ * @brief Stores the acceleration of body i from the sums of its row; a body without mass is not
+ * accelerated.
+ */
+void store_row(NB::BodyStore& bodies, const std::size_t i, const double sumX, const double sumY) {
+    const auto isMassless = bodies.mass[i] == 0.0;
+    bodies.ax[i] = isMassless ? 0.0 : NB::GravitationalConstant * sumX;
+    bodies.ay[i] = isMassless ? 0.0 : NB::GravitationalConstant * sumY;
+}
+
+#ifdef NB_HAS_X86_KERNELS
+
+/**
+ * @brief Computes the rows in [begin, end) four bodies j at a time with AVX2.
+ */
+__attribute__((target("avx2,fma"))) void compute_rows_avx2(
+    NB::BodyStore& bodies, const std::size_t begin, const std::size_t end) {
+    const auto count = bodies.size();
+    const auto vectorEnd = count - count % 4;
+    const auto zero = _mm256_setzero_pd();
+    for (auto i = begin; i < end; ++i) {
+        const auto xi = _mm256_set1_pd(bodies.x[i]);
+        const auto yi = _mm256_set1_pd(bodies.y[i]);
+        auto sumX = _mm256_setzero_pd();
+        auto sumY = _mm256_setzero_pd();
+        for (std::size_t j = 0; j < vectorEnd; j += 4) {
+            const auto dx = _mm256_sub_pd(_mm256_loadu_pd(&bodies.x[j]), xi);
+            const auto dy = _mm256_sub_pd(_mm256_loadu_pd(&bodies.y[j]), yi);
+            const auto distanceSquared = _mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy));
+            const auto distanceCubed =
+                _mm256_mul_pd(distanceSquared, _mm256_sqrt_pd(distanceSquared));
+
+            // The lanes of the bodies at the position of body i (including itself) are zeroed
+            const auto isApart = _mm256_cmp_pd(distanceSquared, zero, _CMP_GT_OQ);
+            const auto scale = _mm256_and_pd(
+                isApart, _mm256_div_pd(_mm256_loadu_pd(&bodies.mass[j]), distanceCubed));
+            sumX = _mm256_fmadd_pd(scale, dx, sumX);
+            sumY = _mm256_fmadd_pd(scale, dy, sumY);
+        }
+
+        alignas(32) double lanesX[4];
+        alignas(32) double lanesY[4];
+        _mm256_store_pd(lanesX, sumX);
+        _mm256_store_pd(lanesY, sumY);
+        auto rowX = (lanesX[0] + lanesX[1]) + (lanesX[2] + lanesX[3]);
+        auto rowY = (lanesY[0] + lanesY[1]) + (lanesY[2] + lanesY[3]);
+        accumulate_row_scalar(bodies, i, vectorEnd, count, rowX, rowY);
+        store_row(bodies, i, rowX, rowY);
+    }
+}
+
+/**
+ * @brief Computes the rows in [begin, end) eight bodies j at a time with AVX-512.
+ */
+__attribute__((target("avx512f"))) void compute_rows_avx512(
+    NB::BodyStore& bodies, const std::size_t begin, const std::size_t end) {
+    const auto count = bodies.size();
+    const auto vectorEnd = count - count % 8;
+    const auto zero = _mm512_setzero_pd();
+    const auto half = _mm512_set1_pd(0.5);
+    const auto threeHalves = _mm512_set1_pd(1.5);
+    for (auto i = begin; i < end; ++i) {
+        const auto xi = _mm512_set1_pd(bodies.x[i]);
+        const auto yi = _mm512_set1_pd(bodies.y[i]);
+        auto sumX = _mm512_setzero_pd();
+        auto sumY = _mm512_setzero_pd();
+        for (std::size_t j = 0; j < vectorEnd; j += 8) {
+            const auto dx = _mm512_sub_pd(_mm512_loadu_pd(&bodies.x[j]), xi);
+            const auto dy = _mm512_sub_pd(_mm512_loadu_pd(&bodies.y[j]), yi);
+            const auto distanceSquared = _mm512_fmadd_pd(dx, dx, _mm512_mul_pd(dy, dy));
+
+            // The lanes of the bodies at the position of body i (including itself) are zeroed.
+            // The 14-bit reciprocal square root is refined twice by Newton's method, which is
+            // close to the precision of a division but much faster
+            const auto isApart = _mm512_cmp_pd_mask(distanceSquared, zero, _CMP_GT_OQ);
+            const auto halfDistanceSquared = _mm512_mul_pd(half, distanceSquared);
+            auto inverseDistance = _mm512_maskz_rsqrt14_pd(isApart, distanceSquared);
+            for (int iteration = 0; iteration < 2; ++iteration) {
+                const auto product = _mm512_mul_pd(
+                    _mm512_mul_pd(halfDistanceSquared, inverseDistance), inverseDistance);
+                inverseDistance =
+                    _mm512_mul_pd(inverseDistance, _mm512_sub_pd(threeHalves, product));
+            }
+            const auto inverseDistanceCubed = _mm512_mul_pd(
+                _mm512_mul_pd(inverseDistance, inverseDistance), inverseDistance);
+            const auto scale =
+                _mm512_mul_pd(_mm512_loadu_pd(&bodies.mass[j]), inverseDistanceCubed);
+            sumX = _mm512_fmadd_pd(scale, dx, sumX);
+            sumY = _mm512_fmadd_pd(scale, dy, sumY);
+        }
+
+        alignas(64) double lanesX[8];
+        alignas(64) double lanesY[8];
+        _mm512_store_pd(lanesX, sumX);
+        _mm512_store_pd(lanesY, sumY);
+        auto rowX = ((lanesX[0] + lanesX[1]) + (lanesX[2] + lanesX[3])) +
+                    ((lanesX[4] + lanesX[5]) + (lanesX[6] + lanesX[7]));
+        auto rowY = ((lanesY[0] + lanesY[1]) + (lanesY[2] + lanesY[3])) +
+                    ((lanesY[4] + lanesY[5]) + (lanesY[6] + lanesY[7]));
+        accumulate_row_scalar(bodies, i, vectorEnd, count, rowX, rowY);
+        store_row(bodies, i, rowX, rowY);
+    }
+}
+
+#endif
+
+}  // namespace
+
+namespace NB {
+
+KernelIsa detectKernelIsa() {
+#ifdef NB_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return KernelIsa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KernelIsa::Avx2;
+    }
+#endif
+
+    return KernelIsa::Scalar;
+}
+
+std::string_view kernelIsaName(const KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Avx2:
+            return "avx2";
+        case KernelIsa::Avx512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+void computeAccelerations(BodyStore& bodies) {
+    const auto count = bodies.size();
+    const auto* const x = bodies.x.data();
+    const auto* const y = bodies.y.data();
+    const auto* const mass = bodies.mass.data();
+    auto* const ax = bodies.ax.data();
+    auto* const ay = bodies.ay.data();
+
+    // Accumulate the net forces first; they are divided by the masses at the end
+    std::fill(ax, ax + count, 0.0);
+    std::fill(ay, ay + count, 0.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = i + 1; j < count; ++j) {
+            const auto dx = x[j] - x[i];
+            const auto dy = y[j] - y[i];
+            const auto distance = std::sqrt(dx * dx + dy * dy);
+            if (distance == 0.0) {
+                continue;
+            }
+
+            const auto gravityMagnitude =
+                GravitationalConstant * mass[i] * mass[j] / (distance * distance);
+            const auto forceX = dx / distance * gravityMagnitude;
+            const auto forceY = dy / distance * gravityMagnitude;
+            ax[i] += forceX;
+            ay[i] += forceY;
+            ax[j] -= forceX;
+            ay[j] -= forceY;
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto accelerationX = ax[i] / mass[i];
+        const auto accelerationY = ay[i] / mass[i];
+        ax[i] = std::isnan(accelerationX) ? 0.0 : accelerationX;
+        ay[i] = std::isnan(accelerationY) ? 0.0 : accelerationY;
+    }
+}
+
+void computeAccelerationRows(
+    BodyStore& bodies, const std::size_t begin, const std::size_t end, const KernelIsa isa) {
+#ifdef NB_HAS_X86_KERNELS
+    if (isa == KernelIsa::Avx512) {
+        compute_rows_avx512(bodies, begin, end);
+        return;
+    }
+    if (isa == KernelIsa::Avx2) {
+        compute_rows_avx2(bodies, begin, end);
+        return;
+    }
+#endif
+
+    for (auto i = begin; i < end; ++i) {
+        auto rowX = 0.0;
+        auto rowY = 0.0;
+        accumulate_row_scalar(bodies, i, 0, bodies.size(), rowX, rowY);
+        store_row(bodies, i, rowX, rowY);
+    }
+}
+
+AccelerationError compareAccelerations(const BodyStore& bodies, const BodyStore& reference) {
+    if (bodies.size() != reference.size()) {
+        throw std::invalid_argument("The stores of the bodies to compare have different sizes.");
+    }
+
+    const auto count = bodies.size();
+    auto referenceSquareSum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        referenceSquareSum += reference.ax[i] * reference.ax[i] + reference.ay[i] * reference.ay[i];
+    }
+    AccelerationError error;
+    if (referenceSquareSum == 0.0) {
+        return error;
+    }
+
+    const auto rootMeanSquare = std::sqrt(referenceSquareSum / static_cast<double>(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto difference =
+            std::hypot(bodies.ax[i] - reference.ax[i], bodies.ay[i] - reference.ay[i]);
+        error.mean += difference;
+        error.max = std::max(error.max, difference);
+    }
+    error.mean /= static_cast<double>(count) * rootMeanSquare;
+    error.max /= rootMeanSquare;
+
+    return error;
+}
+
+}  // namespace NB
@@ -0,0 +1,71 @@
+// Copyright 2024 James Chen
+
+#ifndef GRAVITYKERNEL_HPP
+#define GRAVITYKERNEL_HPP
+
+#include <string_view>
+#include "BodyStore.hpp"
+
+namespace NB {
+
+/**
+ * @brief Enumerates the instruction sets that the force kernels are written for.
+ */
+enum class KernelIsa { Scalar, Avx2, Avx512 };
+
+/**
+ * @brief The errors of approximate accelerations: the mean and the largest length of the
+ * difference from the reference, relative to the root mean square of the reference accelerations.
+ * A body whose forces nearly cancel out does not blow the errors up, as it would relative to its
+ * own acceleration.
+ */
+struct AccelerationError {
+    double mean = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief Returns the widest instruction set that both this build and the running CPU support.
+ */
+[[nodiscard]] KernelIsa detectKernelIsa();
+
+/**
+ * @brief Returns the name of an instruction set, such as "avx2".
+ */
+[[nodiscard]] std::string_view kernelIsaName(KernelIsa isa);
+
+/**
+ * @brief Computes the acceleration of every body due to the gravity of all the others, and stores
+ * it in the acceleration arrays of the store. Each pair of bodies is visited once, and its force
+ * is added to one body and subtracted from the other (Newton's third law). A body without mass is
+ * not accelerated, and two bodies at the same position exert no force on each other. Nothing is
+ * allocated. This is the scalar reference that the other kernels are checked against.
+ * @param bodies The bodies; the acceleration arrays must have the size of the store.
+ */
+void computeAccelerations(BodyStore& bodies);
+
+/**
+ * @brief Computes the accelerations of a range of bodies, each against all the bodies, with the
+ * same rules as computeAccelerations(). The pairs are visited twice overall, but the rows are
+ * independent, so they vectorize and can be split among threads; the result of a body does not
+ * depend on the range it is computed in.
+ * @param bodies The bodies; the acceleration arrays must have the size of the store.
+ * @param begin The index of the first body of the range.
+ * @param end The index after the last body of the range.
+ * @param isa The instruction set to use; it must be supported by the CPU (see detectKernelIsa).
+ */
+void computeAccelerationRows(BodyStore& bodies, std::size_t begin, std::size_t end, KernelIsa isa);
+
+/**
+ * @brief Compares the accelerations of two stores of the same bodies; the errors are 0 if no body
+ * is accelerated in the reference.
+ * @param bodies The bodies with the approximate accelerations.
+ * @param reference The bodies with the reference accelerations.
+ * @throws std::invalid_argument if the stores have different sizes.
+ */
+[[nodiscard]] AccelerationError compareAccelerations(
+    const BodyStore& bodies, const BodyStore& reference);
+
+}  // namespace NB
+
+#endif
@@ -44,6 +44,10 @@ constexpr double GravitationalConstant = 6.67e-11;
 constexpr int SEONCDS_IN_DAY = 86400;
 constexpr int SEONCDS_IN_YEAR = 31536000;
 
+// The names of the solvers in a universe file
+constexpr std::string_view SOLVER_NAME_EXACT = "exact";
+constexpr std::string_view SOLVER_NAME_BARNES_HUT = "barnes-hut";
+
 }  // namespace NB
 
 #endif
@@ -0,0 +1,201 @@
+// Copyright 2024 James Chen
+
+#include "QuadTree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "NBodyConstant.hpp"
+
+namespace {
+
+/**
+ * @brief Adds the attraction of a point mass to the sums of a body: m * (p - p_i) / |p - p_i|^3;
+ * a mass at the position of the body exerts no force.
+ */
+void add_attraction(
+    const double mass, const double dx, const double dy, double& sumX, double& sumY) {
+    const auto distanceSquared = dx * dx + dy * dy;
+    if (distanceSquared == 0.0) {
+        return;
+    }
+
+    const auto scale = mass / (distanceSquared * std::sqrt(distanceSquared));
+    sumX += scale * dx;
+    sumY += scale * dy;
+}
+
+}  // namespace
+
+namespace NB {
+
+QuadTree::QuadTree(const double openingAngle) { setOpeningAngle(openingAngle); }
+
+double QuadTree::openingAngle() const { return m_openingAngle; }
+
+void QuadTree::setOpeningAngle(const double openingAngle) {
+    if (!(openingAngle >= 0.0)) {
+        throw std::invalid_argument("The opening angle must be a non-negative number.");
+    }
+
+    m_openingAngle = openingAngle;
+}
+
+void QuadTree::build(const BodyStore& bodies) {
+    // The pool keeps its capacity, so it only allocates when the tree grows past its largest size
+    m_nodes.clear();
+    const auto count = bodies.size();
+    if (count == 0) {
+        return;
+    }
+
+    const auto [minX, maxX] = std::minmax_element(bodies.x.cbegin(), bodies.x.cend());
+    const auto [minY, maxY] = std::minmax_element(bodies.y.cbegin(), bodies.y.cend());
+    Node root;
+    root.centerX = (*minX + *maxX) / 2;
+    root.centerY = (*minY + *maxY) / 2;
+    root.halfSize = std::max(*maxX - *minX, *maxY - *minY) / 2;
+    m_nodes.push_back(root);
+
+    for (std::size_t body = 0; body < count; ++body) {
+        insert(bodies, static_cast<int32_t>(body));
+    }
+    finish(bodies);
+}
+
+void QuadTree::computeAccelerationRows(
+    BodyStore& bodies, const std::size_t begin, const std::size_t end) const {
+    for (auto i = begin; i < end; ++i) {
+        auto sumX = 0.0;
+        auto sumY = 0.0;
+        if (!m_nodes.empty()) {
+            accumulate(0, bodies, static_cast<int32_t>(i), sumX, sumY);
+        }
+
+        // A body without mass is not accelerated
+        const auto isMassless = bodies.mass[i] == 0.0;
+        bodies.ax[i] = isMassless ? 0.0 : GravitationalConstant * sumX;
+        bodies.ay[i] = isMassless ? 0.0 : GravitationalConstant * sumY;
+    }
+}
+
+std::size_t QuadTree::nodeCount() const { return m_nodes.size(); }
+
+void QuadTree::insert(const BodyStore& bodies, const int32_t body) {
+    std::size_t nodeIndex = 0;
+    for (int depth = 0;; ++depth) {
+        addMass(nodeIndex, bodies, body);
+        if (m_nodes[nodeIndex].firstChild >= 0) {
+            nodeIndex = childAt(nodeIndex, bodies.x[body], bodies.y[body]);
+            continue;
+        }
+
+        // A free leaf takes the body; a full leaf at the maximum depth shares it
+        const auto leafBody = m_nodes[nodeIndex].body;
+        if (leafBody == NO_BODY) {
+            m_nodes[nodeIndex].body = body;
+            return;
+        }
+        if (depth == MAX_DEPTH) {
+            m_nodes[nodeIndex].body = SEVERAL_BODIES;
+            return;
+        }
+
+        // Otherwise the leaf is split, and its body is moved down to a child
+        subdivide(nodeIndex);
+        const auto childIndex = childAt(nodeIndex, bodies.x[leafBody], bodies.y[leafBody]);
+        addMass(childIndex, bodies, leafBody);
+        m_nodes[childIndex].body = leafBody;
+        nodeIndex = childAt(nodeIndex, bodies.x[body], bodies.y[body]);
+    }
+}
+
+void QuadTree::addMass(const std::size_t nodeIndex, const BodyStore& bodies, const int32_t body) {
+    auto& node = m_nodes[nodeIndex];
+    const auto mass = bodies.mass[body];
+    node.mass += mass;
+    node.centerOfMassX += mass * bodies.x[body];
+    node.centerOfMassY += mass * bodies.y[body];
+    node.hasNegativeMass = node.hasNegativeMass || mass < 0.0;
+}
+
+void QuadTree::subdivide(const std::size_t nodeIndex) {
+    const auto parent = m_nodes[nodeIndex];
+    const auto halfSize = parent.halfSize / 2;
+    m_nodes[nodeIndex].firstChild = static_cast<int32_t>(m_nodes.size());
+    m_nodes[nodeIndex].body = NO_BODY;
+
+    // The quadrants are ordered as in childAt(): bit 0 is the east half, bit 1 the south half
+    for (int quadrant = 0; quadrant < 4; ++quadrant) {
+        Node child;
+        child.centerX = parent.centerX + ((quadrant & 1) != 0 ? halfSize : -halfSize);
+        child.centerY = parent.centerY + ((quadrant & 2) != 0 ? halfSize : -halfSize);
+        child.halfSize = halfSize;
+        m_nodes.push_back(child);
+    }
+}
+
+void QuadTree::finish(const BodyStore& bodies) {
+    // A node is opened when width / distance >= θ, that is when distance^2 <= (width / θ)^2;
+    // with θ = 0, every node is opened
+    const auto inverseOpeningAngleSquared =
+        m_openingAngle > 0.0 ? 1.0 / (m_openingAngle * m_openingAngle)
+                             : std::numeric_limits<double>::infinity();
+    for (auto& node : m_nodes) {
+        if (node.body >= 0) {
+            // The position of a single body is kept exact
+            node.centerOfMassX = bodies.x[node.body];
+            node.centerOfMassY = bodies.y[node.body];
+        } else if (node.mass != 0.0) {
+            node.centerOfMassX /= node.mass;
+            node.centerOfMassY /= node.mass;
+        }
+
+        const auto width = 2 * node.halfSize;
+        node.openingDistanceSquared = width * width * inverseOpeningAngleSquared;
+    }
+}
+
+std::size_t QuadTree::childAt(const std::size_t nodeIndex, const double x, const double y) const {
+    const auto& node = m_nodes[nodeIndex];
+    const auto quadrant = (x >= node.centerX ? 1 : 0) + (y >= node.centerY ? 2 : 0);
+
+    return static_cast<std::size_t>(node.firstChild + quadrant);
+}
+
+void QuadTree::accumulate(
+    const std::size_t nodeIndex, const BodyStore& bodies, const int32_t body, double& sumX,
+    double& sumY) const {
+    const auto& node = m_nodes[nodeIndex];
+    if (node.mass == 0.0 && !node.hasNegativeMass) {
+        return;
+    }
+
+    const auto x = bodies.x[body];
+    const auto y = bodies.y[body];
+    const auto dx = node.centerOfMassX - x;
+    const auto dy = node.centerOfMassY - y;
+    const auto isOutside =
+        std::abs(x - node.centerX) > node.halfSize || std::abs(y - node.centerY) > node.halfSize;
+    if (node.firstChild < 0) {
+        // A leaf of one body is exact (an empty leaf has no mass and was skipped). The bodies of a
+        // shared leaf are at nearly the same position, so they exert no force on each other like
+        // bodies at the same position; their center of mass may be rounded off their position
+        if (node.body >= 0 || isOutside) {
+            add_attraction(node.mass, dx, dy, sumX, sumY);
+        }
+        return;
+    }
+
+    // A node is not approximated if it contains the body, whose own mass would pull it
+    if (!node.hasNegativeMass && dx * dx + dy * dy > node.openingDistanceSquared && isOutside) {
+        add_attraction(node.mass, dx, dy, sumX, sumY);
+        return;
+    }
+
+    for (int quadrant = 0; quadrant < 4; ++quadrant) {
+        accumulate(static_cast<std::size_t>(node.firstChild + quadrant), bodies, body, sumX, sumY);
+    }
+}
+
+}  // namespace NB
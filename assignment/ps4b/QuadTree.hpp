@@ -0,0 +1,160 @@
+// Copyright 2024 James Chen
+
+#ifndef QUADTREE_HPP
+#define QUADTREE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "BodyStore.hpp"
+
+namespace NB {
+
+/**
+ * @brief This class approximates the gravity of the bodies with the Barnes-Hut method. The tree
+ * divides the bounding square of the bodies into quadrants until each leaf holds one body, and
+ * every node keeps the mass and the center of mass of the bodies inside it. A node that looks
+ * small enough from a body (its width over its distance is below the opening angle) acts as a
+ * single body, so a force evaluation costs O(N log N) instead of O(N^2).
+ *
+ * The nodes live in a pool that is cleared but not freed when the tree is rebuilt, so once the pool
+ * has grown to the size a universe needs, a step does not allocate. A node that holds a body with
+ * a negative mass is always opened, since its center of mass would be meaningless.
+ */
+class QuadTree {
+ public:
+    /**
+     * @brief The default opening angle, a common trade-off between speed and accuracy.
+     */
+    static constexpr double DEFAULT_OPENING_ANGLE = 0.5;
+
+    /**
+     * @brief The maximum depth of the tree; bodies that are still together at this depth share a
+     * leaf, and exert no force on each other.
+     */
+    static constexpr int MAX_DEPTH = 48;
+
+    /**
+     * @brief Creates an empty tree.
+     * @param openingAngle The opening angle θ; 0 opens every node, which gives the exact forces.
+     * @throws std::invalid_argument if the opening angle is negative or not a number.
+     */
+    explicit QuadTree(double openingAngle = DEFAULT_OPENING_ANGLE);
+
+    /**
+     * @brief Returns the opening angle.
+     */
+    [[nodiscard]] double openingAngle() const;
+
+    /**
+     * @brief Sets the opening angle.
+     * @throws std::invalid_argument if the opening angle is negative or not a number.
+     */
+    void setOpeningAngle(double openingAngle);
+
+    /**
+     * @brief Rebuilds the tree over the current positions of the bodies.
+     */
+    void build(const BodyStore& bodies);
+
+    /**
+     * @brief Computes the approximate accelerations of a range of bodies from the tree, with the
+     * same rules as computeAccelerations(): a body without mass is not accelerated, and two bodies
+     * at the same position exert no force on each other. The tree must have been built over the
+     * current positions. The nodes are visited in a fixed order, so the rows can be split among
+     * threads without changing the result.
+     * @param bodies The bodies the tree was built over.
+     * @param begin The index of the first body of the range.
+     * @param end The index after the last body of the range.
+     */
+    void computeAccelerationRows(BodyStore& bodies, std::size_t begin, std::size_t end) const;
+
+    /**
+     * @brief Returns the number of nodes of the tree.
+     */
+    [[nodiscard]] std::size_t nodeCount() const;
+
+ private:
+    /**
+     * @brief The body index of an empty leaf.
+     */
+    static constexpr int32_t NO_BODY = -1;
+
+    /**
+     * @brief The body index of a leaf at the maximum depth that holds several bodies.
+     */
+    static constexpr int32_t SEVERAL_BODIES = -2;
+
+    /**
+     * @brief A square of the tree.
+     */
+    struct Node {
+        double centerX = 0.0;
+        double centerY = 0.0;
+        double halfSize = 0.0;
+
+        // The total mass of the bodies inside, and the mass-weighted sums of their positions,
+        // which become the center of mass once the tree is built
+        double mass = 0.0;
+        double centerOfMassX = 0.0;
+        double centerOfMassY = 0.0;
+
+        // The squared distance beyond which the node acts as a single body
+        double openingDistanceSquared = 0.0;
+
+        // The index of the first of the four children, or -1 for a leaf
+        int32_t firstChild = -1;
+
+        // The body of a leaf, NO_BODY or SEVERAL_BODIES
+        int32_t body = NO_BODY;
+
+        bool hasNegativeMass = false;
+    };
+
+    /**
+     * @brief Inserts a body from the root down to a free leaf, splitting the leaves on the way.
+     */
+    void insert(const BodyStore& bodies, int32_t body);
+
+    /**
+     * @brief Adds the mass of a body to a node.
+     */
+    void addMass(std::size_t nodeIndex, const BodyStore& bodies, int32_t body);
+
+    /**
+     * @brief Appends the four children of a leaf to the pool.
+     */
+    void subdivide(std::size_t nodeIndex);
+
+    /**
+     * @brief Turns the mass-weighted sums of the positions into centers of mass, and computes the
+     * opening distances.
+     */
+    void finish(const BodyStore& bodies);
+
+    /**
+     * @brief Returns the index of the child of a node whose quadrant contains a position.
+     */
+    [[nodiscard]] std::size_t childAt(std::size_t nodeIndex, double x, double y) const;
+
+    /**
+     * @brief Adds the sum of m * (p - p_i) / |p - p_i|^3 over the bodies of a node to the sums of
+     * body i.
+     */
+    void accumulate(std::size_t nodeIndex, const BodyStore& bodies, int32_t body, double& sumX,
+                    double& sumY) const;
+
+    /**
+     * @brief The opening angle.
+     */
+    double m_openingAngle;
+
+    /**
+     * @brief The pool of the nodes; the root is the first one, and the four children of a node are
+     * next to each other.
+     */
+    std::vector<Node> m_nodes;
+};
+
+}  // namespace NB
+
+#endif
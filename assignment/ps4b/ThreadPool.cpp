@@ -0,0 +1,85 @@
+// Copyright 2024 James Chen
+
+#include "ThreadPool.hpp"
+#include <stdexcept>
+
+namespace NB {
+
+ThreadPool::ThreadPool(const std::size_t threadCount) {
+    if (threadCount == 0) {
+        throw std::invalid_argument("The thread count of the pool must be positive.");
+    }
+
+    m_workers.reserve(threadCount - 1);
+    for (std::size_t blockIndex = 1; blockIndex < threadCount; ++blockIndex) {
+        m_workers.emplace_back(&ThreadPool::work, this, blockIndex);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{ m_mutex };
+        m_isStopping = true;
+    }
+    m_startCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::threadCount() const { return m_workers.size() + 1; }
+
+void ThreadPool::run(
+    const std::size_t begin, const std::size_t end, const Task task, const void* context) {
+    {
+        std::lock_guard lock{ m_mutex };
+        m_task = task;
+        m_context = context;
+        m_begin = begin;
+        m_end = end;
+        m_pendingWorkerCount = m_workers.size();
+        ++m_generation;
+    }
+    m_startCondition.notify_all();
+
+    runBlock(0);
+
+    std::unique_lock lock{ m_mutex };
+    m_doneCondition.wait(lock, [this] { return m_pendingWorkerCount == 0; });
+}
+
+void ThreadPool::runBlock(const std::size_t blockIndex) const {
+    const auto count = m_end - m_begin;
+    const auto threads = threadCount();
+    const auto blockBegin = m_begin + count * blockIndex / threads;
+    const auto blockEnd = m_begin + count * (blockIndex + 1) / threads;
+    if (blockBegin < blockEnd) {
+        m_task(m_context, blockBegin, blockEnd);
+    }
+}
+
+void ThreadPool::work(const std::size_t blockIndex) {
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock{ m_mutex };
+            m_startCondition.wait(
+                lock, [&] { return m_isStopping || m_generation != generation; });
+            if (m_isStopping) {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        // The state of the loop is not changed until every worker has finished its block
+        runBlock(blockIndex);
+
+        std::lock_guard lock{ m_mutex };
+        if (--m_pendingWorkerCount == 0) {
+            m_doneCondition.notify_one();
+        }
+    }
+}
+
+}  // namespace NB
@@ -0,0 +1,144 @@
+// Copyright 2024 James Chen
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NB {
+
+/**
+ * @brief This class keeps a fixed number of worker threads alive between steps, so a parallel
+ * loop does not create threads. A loop over a range is split into one contiguous block for each
+ * thread, and the calling thread works on the first block. The split only depends on the range and
+ * the thread count, and running a loop does not allocate.
+ */
+class ThreadPool {
+ public:
+    /**
+     * @brief Creates a thread pool.
+     * @param threadCount The number of threads that work on a loop, including the calling thread.
+     * @throws std::invalid_argument if the thread count is 0.
+     */
+    explicit ThreadPool(std::size_t threadCount);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Returns the number of threads that work on a loop, including the calling thread.
+     */
+    [[nodiscard]] std::size_t threadCount() const;
+
+    /**
+     * @brief Calls a function on each block of a range on the threads of the pool, and returns when
+     * all blocks are done. Blocks can be empty when the range is shorter than the thread count.
+     * @param begin The first index of the range.
+     * @param end The index after the last one of the range.
+     * @param function The function called with the first index and the index after the last one of
+     * a block; it must not throw.
+     */
+    template <typename Function>
+    void parallelFor(const std::size_t begin, const std::size_t end, const Function& function) {
+        run(begin, end, &invoke<Function>, &function);
+    }
+
+ private:
+    /**
+     * @brief A type-erased block function: the context, and the range of the block.
+     */
+    using Task = void (*)(const void*, std::size_t, std::size_t);
+
+    /**
+     * @brief Calls a function of a known type through its type-erased pointer.
+     */
+    template <typename Function>
+    static void invoke(const void* context, const std::size_t begin, const std::size_t end) {
+        (*static_cast<const Function*>(context))(begin, end);
+    }
+
+    /**
+     * @brief Starts the workers on a loop, works on the first block and waits for the others.
+     */
+    void run(std::size_t begin, std::size_t end, Task task, const void* context);
+
+    /**
+     * @brief Runs the task on a block of the current loop.
+     */
+    void runBlock(std::size_t blockIndex) const;
+
+    /**
+     * @brief The loop of a worker thread: waits for a loop and works on its block.
+     * @param blockIndex The index of the block of the worker, from 1.
+     */
+    void work(std::size_t blockIndex);
+
+    /**
+     * @brief The worker threads; there is one fewer than the thread count.
+     */
+    std::vector<std::thread> m_workers;
+
+    /**
+     * @brief The mutex that guards the state of the current loop.
+     */
+    std::mutex m_mutex;
+
+    /**
+     * @brief Notified when a loop starts or the pool stops.
+     */
+    std::condition_variable m_startCondition;
+
+    /**
+     * @brief Notified when the last worker finishes its block.
+     */
+    std::condition_variable m_doneCondition;
+
+    /**
+     * @brief The number of loops started; a worker waits until it changes.
+     */
+    uint64_t m_generation = 0;
+
+    /**
+     * @brief The number of workers that have not finished their block of the current loop.
+     */
+    std::size_t m_pendingWorkerCount = 0;
+
+    /**
+     * @brief Whether the workers should exit.
+     */
+    bool m_isStopping = false;
+
+    /**
+     * @brief The task of the current loop.
+     */
+    Task m_task = nullptr;
+
+    /**
+     * @brief The context of the task of the current loop.
+     */
+    const void* m_context = nullptr;
+
+    /**
+     * @brief The first index of the range of the current loop.
+     */
+    std::size_t m_begin = 0;
+
+    /**
+     * @brief The index after the last one of the range of the current loop.
+     */
+    std::size_t m_end = 0;
+};
+
+}  // namespace NB
+
+#endif
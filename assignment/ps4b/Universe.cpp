@@ -4,11 +4,15 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
-#include <limits>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <SFML/Audio.hpp>
+#include "FrameProfiler.hpp"
+#include "GravityKernel.hpp"
 #include "NBodyConstant.hpp"
+#include "ResourceCache.hpp"
 
 /**
  * @brief Converts a double number into a string in the scientific form.
@@ -30,31 +34,31 @@ std::string to_standard_scientific_string(const double& number) {
     return result;
 }
 
-/**
- * @brief Returns the magnitude of a 2-dimensional vector.
- * @tparam T The type of the vector.
- * @param vector2 The 2-dimensional vector to find the magnitude.
- */
-template <typename T>
-T magnitude_vector2(const sf::Vector2<T>& vector2) {
-    return static_cast<T>(std::sqrt(vector2.x * vector2.x + vector2.y * vector2.y));
-}
+namespace {
 
 /**
- * @brief Returns the normalized form of a 2-dimensional vector.
- * @tparam T The type of the vector.
- * @param vector2 The 2-dimensional vector to normalize.
+ * @brief Parses the opening angle that follows the Barnes-Hut solver on the radius line.
+ * @throws std::invalid_argument if the text is not a number.
  */
-template <typename T>
-sf::Vector2<T> normalize_vector2(const sf::Vector2<T>& vector2) {
-    T magnitude = magnitude_vector2(vector2);
-    if (magnitude == 0) {
-        throw std::invalid_argument("Cannot normalize a zero vector!");
+double parse_opening_angle(const std::string& text) {
+    std::size_t parsedLength = 0;
+    double openingAngle = 0.0;
+    try {
+        openingAngle = std::stod(text, &parsedLength);
+    } catch (const std::logic_error&) {
+        parsedLength = 0;
     }
 
-    return { vector2.x / magnitude, vector2.y / magnitude };
+    if (parsedLength == 0 || parsedLength != text.size()) {
+        throw std::invalid_argument(
+            "The opening angle on the radius line is not a number: " + text);
+    }
+
+    return openingAngle;
 }
 
+}  // namespace
+
 namespace NB {
 
 Universe::Universe() = default;
@@ -76,89 +80,105 @@ double Universe::radius() const { return m_radius; }
 
 double Universe::scale() const { return m_scale; }
 
-void Universe::step(const double deltaTime) {
-    // Calculate the unit vector pointing from one planet to another
-    // unitVector[i][j] stores the unit vector from planet i to planet j
-    auto unitVectorMatrix = createMatrix();
-    for (int i = 0; i < m_numPlanets; ++i) {
-        const auto firstPlanet = m_celestialBodyVector[i];
-        for (int j = i + 1; j < m_numPlanets; ++j) {
-            const auto secondPlanet = m_celestialBodyVector[j];
-            const auto firstToSecondUnitVector =
-                normalize_vector2((secondPlanet->positionDouble() - firstPlanet->positionDouble()));
-            unitVectorMatrix[i][j] = firstToSecondUnitVector;
-            unitVectorMatrix[j][i] = { -firstToSecondUnitVector.x, -firstToSecondUnitVector.y };
-        }
-    }
+const BodyStore& Universe::bodies() const { return m_bodies; }
 
-    // Cacluate the net forces between celestial bodies
-    // netForceMatrix[i][j] stores the gravity from planet i to planet j
-    // summation of netForceMatrix[i] is the gravity exerted on planet i
-    auto netForceMatrix = createMatrix();
-    for (int i = 0; i < m_numPlanets; ++i) {
-        const auto firstPlanet = m_celestialBodyVector[i];
-        for (int j = i + 1; j < m_numPlanets; ++j) {
-            const auto secondPlanet = m_celestialBodyVector[j];
-            const auto distance =
-                magnitude_vector2(firstPlanet->positionDouble() - secondPlanet->positionDouble());
-            const auto gravityMagnitude = GravitationalConstant * firstPlanet->massDouble() *
-                                          secondPlanet->massDouble() / (distance * distance);
-
-            netForceMatrix[i][j] = unitVectorMatrix[i][j] * gravityMagnitude;
-            netForceMatrix[j][i] = unitVectorMatrix[j][i] * gravityMagnitude;
-        }
-    }
+BodyStore& Universe::bodies() { return m_bodies; }
 
-    // Calculate the acceleration
-    // accelerationVector[i] stores the acceleration of planet i
-    std::vector<sf::Vector2<double>> accelerationVector;
-    accelerationVector.reserve(m_numPlanets);
-    for (int i = 0; i < m_numPlanets; ++i) {
-        // Find the resultant of planet i
-        const auto& netForces = netForceMatrix[i];
-        sf::Vector2 resultant{ 0.0, 0.0 };
-        for (int j = 0; j < m_numPlanets; ++j) {
-            resultant = resultant + netForces[j];
-        }
+KernelIsa Universe::kernelIsa() const { return m_kernelIsa; }
 
-        const auto planet = m_celestialBodyVector[i];
-        const auto accelerationX = resultant.x / planet->massDouble();
-        const auto accelerationY = resultant.y / planet->massDouble();
+void Universe::setKernelIsa(const KernelIsa kernelIsa) { m_kernelIsa = kernelIsa; }
 
-        accelerationVector.emplace_back(
-            std::isnan(accelerationX) ? 0 : accelerationX,
-            std::isnan(accelerationY) ? 0 : accelerationY);
-    }
+GravitySolver Universe::solver() const { return m_solver; }
+
+void Universe::setSolver(const GravitySolver solver) { m_solver = solver; }
+
+double Universe::openingAngle() const { return m_quadTree.openingAngle(); }
 
-    // Calculate the new velocity of each planet
-    for (int i = 0; i < m_numPlanets; ++i) {
-        const auto planet = m_celestialBodyVector[i];
-        const auto velocity = planet->velocityDouble();
-        const auto acceleration = accelerationVector[i];
+void Universe::setOpeningAngle(const double openingAngle) {
+    m_quadTree.setOpeningAngle(openingAngle);
+}
+
+AccelerationError Universe::measureSolverError() {
+    auto reference = m_bodies;
+    computeAccelerations(reference);
 
-        planet->velocity(
-            { velocity.x + acceleration.x * deltaTime, velocity.y + acceleration.y * deltaTime });
+    if (m_solver == GravitySolver::BarnesHut) {
+        m_quadTree.build(m_bodies);
     }
+    accelerate(0, m_bodies.size());
+
+    return compareAccelerations(m_bodies, reference);
+}
+
+std::size_t Universe::threadCount() const {
+    return m_threadPool ? m_threadPool->threadCount() : 0;
+}
+
+void Universe::setThreadCount(const std::size_t threadCount) {
+    m_threadPool = threadCount == 0 ? nullptr : std::make_unique<ThreadPool>(threadCount);
+}
 
-    // Calculate the new position of each planet
-    for (int i = 0; i < m_numPlanets; ++i) {
-        const auto planet = m_celestialBodyVector[i];
-        const auto position = planet->positionDouble();
-        const auto velocity = planet->velocityDouble();
+void Universe::step(const double deltaTime) {
+    // The tree is built by one thread; the forces from it are computed by all of them
+    const auto count = m_bodies.size();
+    if (m_solver == GravitySolver::BarnesHut) {
+        m_quadTree.build(m_bodies);
+    }
 
-        planet->position(
-            { position.x + velocity.x * deltaTime, position.y + velocity.y * deltaTime });
+    if (m_threadPool) {
+        // Every body is computed in the same order whatever block it is in, so the result does
+        // not depend on the thread count; the bodies are moved once all accelerations are known
+        m_threadPool->parallelFor(0, count, [this](const std::size_t begin, const std::size_t end) {
+            accelerate(begin, end);
+        });
+        m_threadPool->parallelFor(
+            0, count, [this, deltaTime](const std::size_t begin, const std::size_t end) {
+                integrate(begin, end, deltaTime);
+            });
+    } else {
+        if (m_solver == GravitySolver::Exact && m_kernelIsa == KernelIsa::Scalar) {
+            computeAccelerations(m_bodies);
+        } else {
+            accelerate(0, count);
+        }
+        integrate(0, count, deltaTime);
     }
 
     // Update the elapsed time
     UniverseElapsedTime::step(deltaTime);
 }
 
+void Universe::accelerate(const std::size_t begin, const std::size_t end) {
+    if (m_solver == GravitySolver::BarnesHut) {
+        m_quadTree.computeAccelerationRows(m_bodies, begin, end);
+    } else {
+        computeAccelerationRows(m_bodies, begin, end, m_kernelIsa);
+    }
+}
+
+void Universe::integrate(const std::size_t begin, const std::size_t end, const double deltaTime) {
+    // Calculate the new velocity and then the new position of each planet
+    for (auto i = begin; i < end; ++i) {
+        m_bodies.vx[i] += m_bodies.ax[i] * deltaTime;
+        m_bodies.vy[i] += m_bodies.ay[i] * deltaTime;
+        m_bodies.x[i] += m_bodies.vx[i] * deltaTime;
+        m_bodies.y[i] += m_bodies.vy[i] * deltaTime;
+    }
+}
+
 void Universe::loadResources() {
+    // Decode all the images and the music in the background; the textures are created below
+    auto& resourceCache = RC::ResourceCache::shared();
+    std::vector<std::string> imagePaths{ IMAGE_BACKGRROUND.string() };
+    for (auto const& celestialBody : m_celestialBodyVector) {
+        imagePaths.push_back(celestialBody->imagePath());
+    }
+    resourceCache.prefetchImages(imagePaths);
+    resourceCache.prefetchSoundBuffers({ SOUND_BACKGROUND_MUSIC.string() });
+
     // Load the background image
-    m_backgroundImage.first = { std::make_shared<sf::Texture>() };
+    m_backgroundImage.first = resourceCache.texture(IMAGE_BACKGRROUND.string());
     m_backgroundImage.second = { std::make_shared<sf::Sprite>() };
-    m_backgroundImage.first->loadFromFile(IMAGE_BACKGRROUND);
     m_backgroundImage.second->setTexture(*m_backgroundImage.first);
 
     // Rescale the background image so that the image fits the window
@@ -169,10 +189,10 @@ void Universe::loadResources() {
         static_cast<float>(WINDOW_WIDTH) / static_cast<float>(textureSize.x),
         static_cast<float>(WINDOW_HEIGHT) / static_cast<float>(textureSize.y));
 
-    // Load and play the background music
-    const auto soundBuffer{ std::make_shared<sf::SoundBuffer>() };
-    const auto sound{ std::make_shared<sf::Sound>() };
-    if (soundBuffer->loadFromFile(SOUND_BACKGROUND_MUSIC)) {
+    // Play the background music if it loads
+    const auto soundBuffer = resourceCache.soundBuffer(SOUND_BACKGROUND_MUSIC.string());
+    if (soundBuffer->getSampleCount() > 0) {
+        const auto sound{ std::make_shared<sf::Sound>() };
         sound->setBuffer(*soundBuffer);
         m_backgroundMusic.first = soundBuffer;
         m_backgroundMusic.second = sound;
@@ -188,6 +208,7 @@ void Universe::loadResources() {
 
 void Universe::draw(sf::RenderTarget& target, const sf::RenderStates states) const {
     target.draw(*m_backgroundImage.second, states);
+    FP::countDrawCall();
 
     auto drawCelestialBody = [&](const std::shared_ptr<CelestialBody>& celestialBody) {
         target.draw(*celestialBody, states);
@@ -199,37 +220,51 @@ void Universe::draw(sf::RenderTarget& target, const sf::RenderStates states) con
     UniverseElapsedTime::draw(target, states);
 }
 
-std::vector<std::vector<sf::Vector2<double>>> Universe::createMatrix() const {
-    std::vector<std::vector<sf::Vector2<double>>> matrix;
-    matrix.reserve(m_numPlanets);
-    for (int i = 0; i < m_numPlanets; ++i) {
-        matrix.push_back(std::vector<sf::Vector2<double>>(m_numPlanets, { 0.0, 0.0 }));
-    }
-
-    return matrix;
-}
-
 std::istream& operator>>(std::istream& istream, Universe& universe) {
     istream >> universe.m_numPlanets >> universe.m_radius;
 
+    // The rest of the line of the radius may select the solver; an unknown solver is reported and
+    // the exact solver is kept
+    std::string radiusLine;
+    getline(istream, radiusLine);
+    std::istringstream radiusLineStream{ radiusLine };
+    std::string solverName;
+    radiusLineStream >> solverName;
+    if (solverName == SOLVER_NAME_EXACT) {
+        universe.m_solver = GravitySolver::Exact;
+    } else if (solverName == SOLVER_NAME_BARNES_HUT) {
+        universe.m_solver = GravitySolver::BarnesHut;
+        std::string openingAngle;
+        if (radiusLineStream >> openingAngle) {
+            universe.setOpeningAngle(parse_opening_angle(openingAngle));
+        }
+    } else if (!solverName.empty()) {
+        std::cerr << "Unknown solver on the radius line, using " << SOLVER_NAME_EXACT << ": "
+                  << solverName << std::endl;
+    }
+
     // Set the scale; scale factor enlarges the universe to accommodate all planets' trajectories
     // while they are moving
     universe.m_scale = universe.m_radius / DOUBLE_HALF / WINDOW_WIDTH * SCALE_FACTOR;
 
-    istream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    // Celestial bodies
+    // Celestial bodies; their states are moved into the body store as they are read
+    universe.m_bodies.reserve(universe.m_numPlanets);
     for (int i = 0; i < universe.m_numPlanets; ++i) {
-        auto celestialBody = std::make_shared<CelestialBody>(&universe);
-        universe.m_celestialBodyVector.push_back(celestialBody);
+        auto celestialBody = std::make_shared<CelestialBody>();
         istream >> *celestialBody;
+        celestialBody->attach(&universe);
+        universe.m_celestialBodyVector.push_back(celestialBody);
     }
 
     return istream;
 }
 
 std::ostream& operator<<(std::ostream& ostream, const Universe& universe) {
-    ostream << universe.m_numPlanets << std::endl << universe.m_radius << std::endl;
+    ostream << universe.m_numPlanets << std::endl << universe.m_radius;
+    if (universe.m_solver == GravitySolver::BarnesHut) {
+        ostream << ' ' << SOLVER_NAME_BARNES_HUT << ' ' << universe.openingAngle();
+    }
+    ostream << std::endl;
 
     // Output celestial bodies
     for (size_t i = 0; i < universe.m_celestialBodyVector.size(); ++i) {
@@ -9,13 +9,23 @@
 #include <vector>
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
+#include "BodyStore.hpp"
 #include "CelestialBody.hpp"
+#include "GravityKernel.hpp"
+#include "QuadTree.hpp"
+#include "ThreadPool.hpp"
 #include "UniverseElapsedTime.hpp"
 
 namespace NB {
 
 class CelestialBody;
 
+/**
+ * @brief Enumerates the ways to compute the gravity: all pairs of bodies, or the Barnes-Hut
+ * approximation.
+ */
+enum class GravitySolver { Exact, BarnesHut };
+
 class Universe final : public UniverseElapsedTime {
  public:
     /**
@@ -29,8 +39,18 @@ class Universe final : public UniverseElapsedTime {
      */
     explicit Universe(const std::string& filename);
 
+    // The celestial bodies keep a pointer to their universe, so a universe stays where it is
+    Universe(const Universe&) = delete;
+
+    Universe& operator=(const Universe&) = delete;
+
+    Universe(Universe&&) = delete;
+
+    Universe& operator=(Universe&&) = delete;
+
     /**
-     * @brief Loads resources necessary for the Universe (background image and music).
+     * @brief Loads resources necessary for the Universe (background image and music). The images
+     * and the music are decoded in parallel, and each distinct image is loaded once.
      */
     void loadResources();
 
@@ -52,6 +72,75 @@ class Universe final : public UniverseElapsedTime {
      */
     [[nodiscard]] double scale() const;
 
+    /**
+     * @brief Returns the store of the positions, velocities and masses of the bodies.
+     */
+    [[nodiscard]] const BodyStore& bodies() const;
+
+    /**
+     * @brief Returns the store of the positions, velocities and masses of the bodies.
+     */
+    [[nodiscard]] BodyStore& bodies();
+
+    /**
+     * @brief Returns the instruction set of the force kernel; it defaults to the widest one that
+     * the CPU supports.
+     */
+    [[nodiscard]] KernelIsa kernelIsa() const;
+
+    /**
+     * @brief Sets the instruction set of the force kernel. The scalar kernel is the reference that
+     * visits each pair of bodies once; the vector kernels compute each body against all the others.
+     * @param kernelIsa The instruction set; it must be supported by the CPU (see detectKernelIsa).
+     */
+    void setKernelIsa(KernelIsa kernelIsa);
+
+    /**
+     * @brief Returns the solver of the gravity; a universe file selects it on the line of the
+     * radius, after the radius: "exact" (the default) or "barnes-hut" with an optional opening
+     * angle.
+     */
+    [[nodiscard]] GravitySolver solver() const;
+
+    /**
+     * @brief Sets the solver of the gravity.
+     */
+    void setSolver(GravitySolver solver);
+
+    /**
+     * @brief Returns the opening angle of the Barnes-Hut solver.
+     */
+    [[nodiscard]] double openingAngle() const;
+
+    /**
+     * @brief Sets the opening angle of the Barnes-Hut solver.
+     * @throws std::invalid_argument if the opening angle is negative or not a number.
+     */
+    void setOpeningAngle(double openingAngle);
+
+    /**
+     * @brief Computes the accelerations of the bodies with the solver and with the exact scalar
+     * reference, and compares them. It overwrites the accelerations in the body store, which the
+     * next step computes again, and allocates a copy of the store.
+     */
+    [[nodiscard]] AccelerationError measureSolverError();
+
+    /**
+     * @brief Returns the number of threads of the parallel mode, or 0 in the serial mode.
+     */
+    [[nodiscard]] std::size_t threadCount() const;
+
+    /**
+     * @brief Sets the number of threads that step the Universe. In the parallel mode, the bodies
+     * are split into one block for each thread; a thread computes the accelerations of its block
+     * against all bodies with the row kernel, and then moves its block. Each body is computed in
+     * the same order whatever block it is in, so the result is the same for any thread count. The
+     * serial mode is the default; it uses the scalar reference kernel if that is selected.
+     * @param threadCount The number of threads, including the calling one, or 0 for the serial
+     * mode.
+     */
+    void setThreadCount(std::size_t threadCount);
+
     /**
      * Simulates one step.
      * @param deltaTime Delta time in seconds.
@@ -91,9 +180,15 @@ class Universe final : public UniverseElapsedTime {
 
  private:
     /**
-     * @brief Creates a matrix, in which each element is a double vector.
+     * @brief Computes the accelerations of the bodies in [begin, end) with the solver; the tree of
+     * the Barnes-Hut solver must have been built.
      */
-    std::vector<std::vector<sf::Vector2<double>>> createMatrix() const;
+    void accelerate(std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Moves the bodies in [begin, end) by their accelerations over a delta time.
+     */
+    void integrate(std::size_t begin, std::size_t end, double deltaTime);
 
     /**
      * @brief Number of planets in this Universe.
@@ -111,19 +206,44 @@ class Universe final : public UniverseElapsedTime {
     double m_scale = 1.0;
 
     /**
-     * @brief Vector of CelestialBodies in this Universe.
+     * @brief The positions, velocities and masses of the bodies, which the simulation works on.
+     */
+    BodyStore m_bodies;
+
+    /**
+     * @brief The instruction set of the force kernel.
+     */
+    KernelIsa m_kernelIsa = detectKernelIsa();
+
+    /**
+     * @brief The solver of the gravity.
+     */
+    GravitySolver m_solver = GravitySolver::Exact;
+
+    /**
+     * @brief The tree of the Barnes-Hut solver, which is rebuilt every step.
+     */
+    QuadTree m_quadTree;
+
+    /**
+     * @brief The thread pool of the parallel mode; null in the serial mode.
+     */
+    std::unique_ptr<ThreadPool> m_threadPool;
+
+    /**
+     * @brief Vector of CelestialBodies in this Universe; they are views of the body store.
      */
     std::vector<std::shared_ptr<CelestialBody>> m_celestialBodyVector;
 
     /**
      * @brief Background image of this Universe.
      */
-    std::pair<std::shared_ptr<sf::Texture>, std::shared_ptr<sf::Sprite>> m_backgroundImage;
+    std::pair<std::shared_ptr<const sf::Texture>, std::shared_ptr<sf::Sprite>> m_backgroundImage;
 
     /**
      * @brief Background music of this Universe.
      */
-    std::pair<std::shared_ptr<sf::SoundBuffer>, std::shared_ptr<sf::Sound>> m_backgroundMusic;
+    std::pair<std::shared_ptr<const sf::SoundBuffer>, std::shared_ptr<sf::Sound>> m_backgroundMusic;
 };
 
 }  // namespace NB
@@ -2,11 +2,14 @@
 
 #include "UniverseElapsedTime.hpp"
 #include <string>
+#include "FrameProfiler.hpp"
 #include "NBodyConstant.hpp"
+#include "ResourceCache.hpp"
 
 namespace NB {
 
-UniverseElapsedTime::UniverseElapsedTime() { m_font.loadFromFile(FONT_DIGITAL7); }
+UniverseElapsedTime::UniverseElapsedTime() :
+    m_font(RC::ResourceCache::shared().font(FONT_DIGITAL7.string())) {}
 
 void UniverseElapsedTime::step(const double deltaTime) { m_elapsedTime += deltaTime; }
 
@@ -28,12 +31,13 @@ void UniverseElapsedTime::draw(sf::RenderTarget& target, const sf::RenderStates
     }
 
     sf::Text text;
-    text.setFont(m_font);
+    text.setFont(*m_font);
     text.setString(stringToPrint);
     text.setCharacterSize(FONT_SIZE);
     text.setFillColor(sf::Color::White);
     text.setPosition(FONT_POSITION_X, FONT_POSITION_Y);
     target.draw(text);
+    FP::countDrawCall();
 }
 
 }  // namespace NB
@@ -2,6 +2,7 @@
 
 #ifndef UNIVERSEELAPSEDTIME_HPP
 #define UNIVERSEELAPSEDTIME_HPP
+#include <memory>
 #include <SFML/Graphics.hpp>
 
 namespace NB {
@@ -50,7 +51,7 @@ class UniverseElapsedTime : virtual public sf::Drawable {
     /**
      * @brief The font for the diplayed text.
      */
-    sf::Font m_font;
+    std::shared_ptr<const sf::Font> m_font;
 };
 
 }  // namespace NB
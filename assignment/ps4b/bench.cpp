@@ -0,0 +1,193 @@
+// Copyright 2024 James Chen
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GravityKernel.hpp"
+#include "NBodyConstant.hpp"
+#include "Universe.hpp"
+
+namespace {
+
+/**
+ * @brief Creates the text of a universe of bodies spread uniformly over a disk of a radius of 1e12
+ * meters, with random velocities and masses. The same seed always creates the same universe.
+ */
+std::string random_universe_text(const std::size_t bodyCount, const uint64_t seed) {
+    constexpr double RADIUS = 1.0e12;
+    std::mt19937_64 random{ seed };
+    std::uniform_real_distribution<double> coordinate{ -RADIUS, RADIUS };
+    std::uniform_real_distribution<double> speed{ -1.0e4, 1.0e4 };
+    std::uniform_real_distribution<double> mass{ 1.0e22, 1.0e30 };
+    std::ostringstream text;
+    text << bodyCount << '\n' << RADIUS << '\n';
+    for (std::size_t i = 0; i < bodyCount; ++i) {
+        auto x = coordinate(random);
+        auto y = coordinate(random);
+        while (x * x + y * y > RADIUS * RADIUS) {
+            x = coordinate(random);
+            y = coordinate(random);
+        }
+        text << x << ' ' << y << ' ' << speed(random) << ' ' << speed(random) << ' '
+             << mass(random) << " earth.gif\n";
+    }
+
+    return text.str();
+}
+
+/**
+ * @brief Returns the seconds elapsed since a time point.
+ */
+double seconds_since(const std::chrono::steady_clock::time_point& startTime) {
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    return elapsedTime.count();
+}
+
+}  // namespace
+
+/**
+ * @brief Benchmarks the steps of a universe in the serial mode and in the parallel mode on 1 to a
+ * maximum number of threads, and prints the scaling curve: one line for each mode with the time
+ * per step, the speedup over one thread, the parallel efficiency, and whether the positions are
+ * identical to the ones of one thread. With the Barnes-Hut solver, the error of the accelerations
+ * against the exact solver is printed first.
+ * @param size The size of the argument list.
+ * @param arguments The command line arguments, all optional:
+ *   --file FILE    The universe file to step; a random universe is stepped by default.
+ *   --bodies N     The number of bodies of the random universe; defaults to 2000.
+ *   --steps N      The number of steps of each mode; defaults to 20.
+ *   --threads N    The maximum number of threads; defaults to the number of hardware threads.
+ *   --kernel NAME  The force kernel: scalar, avx2 or avx512; defaults to the widest supported.
+ *   --seed N       The seed of the random universe; defaults to 1.
+ *   --solver NAME  The solver: exact or barnes-hut; defaults to the one of the universe file.
+ *   --theta X      The opening angle of the Barnes-Hut solver; defaults to the one of the file.
+ */
+int main(const int size, const char* arguments[]) {
+    std::string filename;
+    std::size_t bodyCount = 2000;
+    auto stepCount = 20;
+    std::size_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    auto kernelIsa = NB::detectKernelIsa();
+    uint64_t seed = 1;
+    std::string solverName;
+    auto openingAngle = -1.0;
+    for (int i = 1; i + 1 < size; i += 2) {
+        const std::string argument{ arguments[i] };
+        const std::string value{ arguments[i + 1] };
+        if (argument == "--file") {
+            filename = value;
+        } else if (argument == "--bodies") {
+            bodyCount = std::stoull(value);
+        } else if (argument == "--steps") {
+            stepCount = std::stoi(value);
+        } else if (argument == "--threads") {
+            maxThreadCount = std::max<std::size_t>(std::stoull(value), 1);
+        } else if (argument == "--kernel" && value == NB::kernelIsaName(NB::KernelIsa::Scalar)) {
+            kernelIsa = NB::KernelIsa::Scalar;
+        } else if (argument == "--kernel" && value == NB::kernelIsaName(NB::KernelIsa::Avx2)) {
+            kernelIsa = NB::KernelIsa::Avx2;
+        } else if (argument == "--kernel" && value == NB::kernelIsaName(NB::KernelIsa::Avx512)) {
+            kernelIsa = NB::KernelIsa::Avx512;
+        } else if (argument == "--seed") {
+            seed = std::stoull(value);
+        } else if (argument == "--solver" &&
+                   (value == NB::SOLVER_NAME_EXACT || value == NB::SOLVER_NAME_BARNES_HUT)) {
+            solverName = value;
+        } else if (argument == "--theta") {
+            openingAngle = std::stod(value);
+        } else {
+            std::cout << "Unknown option: " << argument << ' ' << value << std::endl;
+            return 1;
+        }
+    }
+
+    if (static_cast<int>(kernelIsa) > static_cast<int>(NB::detectKernelIsa())) {
+        std::cout << "The CPU does not support the kernel: " << NB::kernelIsaName(kernelIsa)
+                  << std::endl;
+        return 1;
+    }
+
+    std::string universeText;
+    if (filename.empty()) {
+        universeText = random_universe_text(bodyCount, seed);
+        filename = "random universe";
+    } else {
+        std::ifstream ifstream{ filename };
+        if (!ifstream.is_open()) {
+            std::cout << "Cannot open: " << filename << std::endl;
+            return 1;
+        }
+        universeText.assign(std::istreambuf_iterator<char>{ ifstream }, {});
+    }
+
+    // Creates a new universe from the text, with the solver options
+    auto readUniverse = [&](NB::Universe& universe) {
+        std::istringstream universeStream{ universeText };
+        universeStream >> universe;
+        universe.setKernelIsa(kernelIsa);
+        if (!solverName.empty()) {
+            universe.setSolver(solverName == NB::SOLVER_NAME_EXACT ? NB::GravitySolver::Exact
+                                                                   : NB::GravitySolver::BarnesHut);
+        }
+        if (openingAngle >= 0.0) {
+            universe.setOpeningAngle(openingAngle);
+        }
+    };
+
+    // Steps a new universe in a mode, and returns the seconds per step and the final positions;
+    // the first step is not timed
+    auto runMode = [&](const std::size_t threadCount) {
+        NB::Universe universe;
+        readUniverse(universe);
+        universe.setThreadCount(threadCount);
+        universe.step(25000.0);
+
+        const auto startTime = std::chrono::steady_clock::now();
+        for (int step = 1; step < stepCount; ++step) {
+            universe.step(25000.0);
+        }
+        const auto secondsPerStep = seconds_since(startTime) / std::max(stepCount - 1, 1);
+
+        return std::make_pair(secondsPerStep, universe.bodies().x);
+    };
+
+    NB::Universe universe;
+    readUniverse(universe);
+    std::cout << filename << ": " << universe.bodies().size() << " bodies, " << stepCount
+              << " steps, " << NB::kernelIsaName(kernelIsa) << " kernel, ";
+    if (universe.solver() == NB::GravitySolver::BarnesHut) {
+        const auto error = universe.measureSolverError();
+        std::cout << NB::SOLVER_NAME_BARNES_HUT << " solver (theta " << universe.openingAngle()
+                  << "; mean error " << error.mean << ", max error " << error.max << ")"
+                  << std::endl;
+    } else {
+        std::cout << NB::SOLVER_NAME_EXACT << " solver" << std::endl;
+    }
+
+    const auto [serialSeconds, serialX] = runMode(0);
+    std::cout << "serial: " << serialSeconds * 1e3 << " ms/step" << std::endl;
+
+    double singleThreadSeconds = 0.0;
+    std::vector<double> singleThreadX;
+    for (std::size_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount) {
+        const auto [seconds, x] = runMode(threadCount);
+        if (threadCount == 1) {
+            singleThreadSeconds = seconds;
+            singleThreadX = x;
+        }
+
+        const auto speedup = seconds > 0.0 ? singleThreadSeconds / seconds : 0.0;
+        std::cout << threadCount << " threads: " << seconds * 1e3 << " ms/step, speedup "
+                  << speedup << ", efficiency " << speedup / static_cast<double>(threadCount) * 100
+                  << "%, " << (x == singleThreadX ? "identical" : "DIFFERENT") << std::endl;
+    }
+
+    return 0;
+}
@@ -1,7 +1,10 @@
 // Copyright 2024 James Chen
 
 #include <iostream>
+#include <string>
 #include <SFML/Graphics.hpp>
+#include "FrameProfiler.hpp"
+#include "FrameProfilerOverlay.hpp"
 #include "NBodyConstant.hpp"
 #include "Universe.hpp"
 
@@ -11,9 +14,13 @@
  * @param argv The arguments vector. This program requires two arguments:
  * 1. T (double): Total time.
  * 2. Delta t (double): time quantum measured in seconds.
+ * The options that follow are:
+ *   --profile     Shows the frame profiler overlay at the start; F3 toggles it anyway.
+ *   --trace FILE  Writes the measurements of every frame to a CSV file.
+ *   --threads N   Steps the universe on N threads; it is stepped on the main thread by default.
  */
 int main(const int argc, const char* argv[]) {
-    if (argc != 3) {
+    if (argc < 3) {
         std::cerr << "Not enough arguments!";
         return 1;
     }
@@ -22,9 +29,28 @@ int main(const int argc, const char* argv[]) {
     const double deltaTime = std::stod(argv[2]);
     double elapsedTime = 0.0;
 
+    // Parse the profiler and thread options
+    FP::FrameProfiler profiler;
+    auto isProfilerVisible = false;
+    std::size_t threadCount = 0;
+    for (int i = 3; i < argc; ++i) {
+        const std::string option{ argv[i] };
+        if (option == "--profile") {
+            isProfilerVisible = true;
+        } else if (option == "--trace" && i + 1 < argc) {
+            profiler.startTrace(argv[++i]);
+        } else if (option == "--threads" && i + 1 < argc) {
+            threadCount = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
     // Create a universe and load data and resources
     NB::Universe universe;
     std::cin >> universe;
+    universe.setThreadCount(threadCount);
     universe.loadResources();
 
     // Create a window
@@ -32,29 +58,45 @@ int main(const int argc, const char* argv[]) {
     sf::RenderWindow window(windowVideoMode, std::string(NB::WINDOW_TITLE));
     window.setFramerateLimit(NB::WINDOW_FPS);
 
+    // The overlay shows the frame time percentiles, draw calls and allocations per frame
+    FP::FrameProfilerOverlay profilerOverlay{ profiler, NB::FONT_DIGITAL7.string() };
+    profilerOverlay.setVisible(isProfilerVisible);
+
     bool hasPrintedFinalState = false;
     while (window.isOpen()) {
+        profiler.beginFrame();
         sf::Event event{};
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
                 break;
             }
+
+            // Toggle the frame profiler overlay
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+                profilerOverlay.setVisible(!profilerOverlay.isVisible());
+            }
         }
 
         if (window.isOpen()) {
             // The simulation stops when T >= t
+            profiler.beginSection(FP::Section::Update);
             if (elapsedTime < totalTime) {
                 universe.step(deltaTime);
             } else if (!hasPrintedFinalState) {
                 std::cout << universe;
                 hasPrintedFinalState = true;
             }
+            profiler.endSection(FP::Section::Update);
 
+            profiler.beginSection(FP::Section::Draw);
             window.clear(sf::Color::White);
             window.draw(universe);
+            window.draw(profilerOverlay);
+            profiler.endSection(FP::Section::Draw);
             window.display();
         }
+        profiler.endFrame();
 
         elapsedTime += deltaTime;
     }
@@ -3,11 +3,21 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE Main
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <new>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <boost/test/unit_test.hpp>
+#include "AllocationCounter.hpp"
+#include "GravityKernel.hpp"
+#include "QuadTree.hpp"
+#include "ThreadPool.hpp"
 #include "Universe.hpp"
 
 constexpr float MASS_MAX_TOLERANCE = 0.1;
@@ -218,3 +228,220 @@ BOOST_AUTO_TEST_CASE(testUniverseStepDifferentDeltaTime) {
     BOOST_REQUIRE_CLOSE(celestialBody.velocity().x, EXPECTED_VELOCITY_X, STEP_TOLERANCE);
     BOOST_REQUIRE_CLOSE(celestialBody.velocity().y, EXPECTED_VELOCITY_Y, STEP_TOLERANCE);
 }
+
+// Tests if the bodies of a universe are views of its body store.
+BOOST_AUTO_TEST_CASE(testUniverseBodyStore) {
+    NB::Universe universe{ "assets/3body.txt" };
+    auto& bodies = universe.bodies();
+    BOOST_REQUIRE_EQUAL(bodies.size(), 3);
+    BOOST_REQUIRE_EQUAL(bodies.y[1], 4.50e10);
+    BOOST_REQUIRE_EQUAL(bodies.vx[1], 3.00e04);
+
+    // A write through a body goes to the store, and the other way around
+    universe[2].position({ 1.0, 2.0 });
+    BOOST_REQUIRE_EQUAL(bodies.x[2], 1.0);
+    BOOST_REQUIRE_EQUAL(bodies.y[2], 2.0);
+    bodies.vx[0] = 5.0;
+    BOOST_REQUIRE_EQUAL(universe[0].velocityDouble().x, 5.0);
+}
+
+// Tests if `Universe::step()` allocates nothing, and the forces of each pair cancel out so the
+// total momentum is kept.
+BOOST_AUTO_TEST_CASE(testUniverseStepAllocationFree) {
+    NB::Universe universe{ "assets/uniform100.txt" };
+    universe.step(25000.0);
+    const auto allocationCount = FP::allocationCount();
+    for (int i = 0; i < 10; ++i) {
+        universe.step(25000.0);
+    }
+    BOOST_REQUIRE_EQUAL(FP::allocationCount(), allocationCount);
+
+    auto& bodies = universe.bodies();
+    NB::computeAccelerations(bodies);
+    double momentumChangeX = 0.0;
+    double largestForceX = 0.0;
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+        momentumChangeX += bodies.mass[i] * bodies.ax[i];
+        largestForceX = std::max(largestForceX, std::abs(bodies.mass[i] * bodies.ax[i]));
+    }
+    BOOST_REQUIRE_SMALL(momentumChangeX / largestForceX, 1e-9);
+}
+
+// Tests if the counting operator new calls the new handler when an allocation fails, and throws
+// `std::bad_alloc` once there is no handler.
+BOOST_AUTO_TEST_CASE(testAllocationCounterNewHandler) {
+    static int handlerCallCount = 0;
+    std::set_new_handler([] {
+        ++handlerCallCount;
+        std::set_new_handler(nullptr);
+    });
+
+    volatile std::size_t size = std::numeric_limits<std::size_t>::max() / 2;
+    const auto allocationCount = FP::allocationCount();
+    BOOST_REQUIRE_THROW(static_cast<void>(::operator new(size)), std::bad_alloc);
+    BOOST_REQUIRE_EQUAL(handlerCallCount, 1);
+    BOOST_REQUIRE_EQUAL(FP::allocationCount(), allocationCount + 1);
+}
+
+// Tests if the vector kernels agree with the scalar reference, including for coincident and
+// massless bodies, and if a row does not depend on the range it is computed in.
+BOOST_AUTO_TEST_CASE(testGravityKernelIsa) {
+    NB::Universe universe{ "assets/uniform100.txt" };
+    auto& bodies = universe.bodies();
+    bodies.add({ bodies.x[3], bodies.y[3] }, { 0.0, 0.0 }, 1.0e25);
+    bodies.add({ 1.0e10, -2.0e10 }, { 0.0, 0.0 }, 0.0);
+    bodies.add({ -3.0e10, 4.0e10 }, { 0.0, 0.0 }, 2.0e28);
+
+    NB::computeAccelerations(bodies);
+    const auto expectedX = bodies.ax;
+    const auto expectedY = bodies.ay;
+    const auto detectedIsa = NB::detectKernelIsa();
+    for (const auto isa : { NB::KernelIsa::Scalar, NB::KernelIsa::Avx2, NB::KernelIsa::Avx512 }) {
+        if (static_cast<int>(isa) > static_cast<int>(detectedIsa)) {
+            continue;
+        }
+
+        BOOST_TEST_CONTEXT("kernel " << NB::kernelIsaName(isa)) {
+            NB::computeAccelerationRows(bodies, 0, bodies.size(), isa);
+            const auto wholeX = bodies.ax;
+            for (std::size_t i = 0; i < bodies.size(); ++i) {
+                BOOST_REQUIRE_CLOSE(bodies.ax[i], expectedX[i], 1e-9);
+                BOOST_REQUIRE_CLOSE(bodies.ay[i], expectedY[i], 1e-9);
+            }
+            BOOST_REQUIRE_EQUAL(bodies.ax[bodies.size() - 2], 0.0);
+
+            NB::computeAccelerationRows(bodies, 0, 37, isa);
+            NB::computeAccelerationRows(bodies, 37, bodies.size(), isa);
+            BOOST_REQUIRE(bodies.ax == wholeX);
+        }
+    }
+}
+
+// Tests if the parallel mode gives the same result for any thread count, and allocates nothing
+// once the pool is created.
+BOOST_AUTO_TEST_CASE(testUniverseParallelStep) {
+    // The serial mode runs the same row kernel, unless only the scalar reference is available
+    NB::Universe serialUniverse{ "assets/uniform100.txt" };
+    BOOST_REQUIRE_EQUAL(serialUniverse.threadCount(), 0);
+    for (int i = 0; i < 5; ++i) {
+        serialUniverse.step(25000.0);
+    }
+    const auto isRowKernel = serialUniverse.kernelIsa() != NB::KernelIsa::Scalar;
+
+    std::vector<double> expectedX;
+    for (const std::size_t threadCount : { 1, 2, 3, 4, 7 }) {
+        BOOST_TEST_CONTEXT(threadCount << " threads") {
+            NB::Universe universe{ "assets/uniform100.txt" };
+            universe.setThreadCount(threadCount);
+            BOOST_REQUIRE_EQUAL(universe.threadCount(), threadCount);
+            universe.step(25000.0);
+            const auto allocationCount = FP::allocationCount();
+            for (int i = 0; i < 4; ++i) {
+                universe.step(25000.0);
+            }
+            BOOST_REQUIRE_EQUAL(FP::allocationCount(), allocationCount);
+
+            if (expectedX.empty()) {
+                expectedX = universe.bodies().x;
+            }
+            BOOST_REQUIRE(universe.bodies().x == expectedX);
+            if (isRowKernel) {
+                BOOST_REQUIRE(universe.bodies().x == serialUniverse.bodies().x);
+                BOOST_REQUIRE(universe.bodies().vy == serialUniverse.bodies().vy);
+            }
+        }
+    }
+
+    BOOST_REQUIRE_THROW(NB::ThreadPool{ 0 }, std::invalid_argument);
+}
+
+// Tests if the Barnes-Hut solver is exact with an opening angle of 0, approximates the exact
+// solver with a larger one, and allocates nothing once its node pool has grown.
+BOOST_AUTO_TEST_CASE(testUniverseBarnesHut) {
+    NB::Universe universe{ "assets/galaxy.txt" };
+    BOOST_REQUIRE(universe.solver() == NB::GravitySolver::Exact);
+    universe.setSolver(NB::GravitySolver::BarnesHut);
+    BOOST_REQUIRE_EQUAL(universe.openingAngle(), NB::QuadTree::DEFAULT_OPENING_ANGLE);
+
+    universe.setOpeningAngle(0.0);
+    BOOST_REQUIRE_SMALL(universe.measureSolverError().max, 1e-12);
+    universe.setOpeningAngle(0.5);
+    const auto error = universe.measureSolverError();
+    BOOST_REQUIRE_SMALL(error.mean, 1e-2);
+    BOOST_REQUIRE_LE(error.mean, error.max);
+    BOOST_REQUIRE_THROW(universe.setOpeningAngle(-1.0), std::invalid_argument);
+
+    universe.step(25000.0);
+    const auto allocationCount = FP::allocationCount();
+    for (int i = 0; i < 5; ++i) {
+        universe.step(25000.0);
+    }
+    BOOST_REQUIRE_EQUAL(FP::allocationCount(), allocationCount);
+
+    // Coincident, massless and negative-mass bodies follow the rules of the exact solver
+    NB::Universe ringUniverse{ "assets/uniform100.txt" };
+    auto& bodies = ringUniverse.bodies();
+    bodies.add({ bodies.x[1], bodies.y[1] }, { 0.0, 0.0 }, 3.0e22);
+    bodies.add({ bodies.x[1], bodies.y[1] }, { 0.0, 0.0 }, 7.0e21);
+    bodies.add({ 3.0e8, 1.0e8 }, { 0.0, 0.0 }, 0.0);
+    bodies.mass[50] = -bodies.mass[50];
+    ringUniverse.setSolver(NB::GravitySolver::BarnesHut);
+    ringUniverse.setOpeningAngle(0.0);
+    BOOST_REQUIRE_SMALL(ringUniverse.measureSolverError().max, 1e-12);
+    BOOST_REQUIRE_EQUAL(bodies.ax.back(), 0.0);
+    ringUniverse.setOpeningAngle(0.5);
+    BOOST_REQUIRE_SMALL(ringUniverse.measureSolverError().mean, 1e-1);
+}
+
+// Tests if a universe file selects the solver on the line of the radius, and if the selection is
+// written back.
+BOOST_AUTO_TEST_CASE(testUniverseSolverSelection) {
+    std::istringstream input{
+        "2\n"
+        "5.0e10 barnes-hut 0.7\n"
+        "1.0e10 0.0 0.0 1.0e4 1.0e24 earth.gif\n"
+        "-1.0e10 0.0 0.0 -1.0e4 1.0e24 earth.gif\n"
+    };
+    NB::Universe universe;
+    input >> universe;
+    BOOST_REQUIRE(universe.solver() == NB::GravitySolver::BarnesHut);
+    BOOST_REQUIRE_EQUAL(universe.openingAngle(), 0.7);
+    BOOST_REQUIRE_EQUAL(universe.numPlanets(), 2);
+
+    std::ostringstream output;
+    output << universe;
+    BOOST_REQUIRE_NE(output.str().find("barnes-hut 0.7"), std::string::npos);
+
+    std::istringstream exactInput{ "1\n1.0e10 exact\n0.0 0.0 0.0 0.0 1.0e24 earth.gif\n" };
+    NB::Universe exactUniverse;
+    exactInput >> exactUniverse;
+    BOOST_REQUIRE(exactUniverse.solver() == NB::GravitySolver::Exact);
+
+    // A misspelled solver is reported and the exact solver is kept
+    std::istringstream misspelledInput{
+        "1\n"
+        "1.0e10 barnes_hut\n"
+        "0.0 0.0 0.0 0.0 1.0e24 earth.gif\n"
+    };
+    std::ostringstream errorOutput;
+    auto* const errorBuffer = std::cerr.rdbuf(errorOutput.rdbuf());
+    NB::Universe misspelledUniverse;
+    misspelledInput >> misspelledUniverse;
+    std::cerr.rdbuf(errorBuffer);
+    BOOST_REQUIRE(misspelledUniverse.solver() == NB::GravitySolver::Exact);
+    BOOST_REQUIRE_NE(errorOutput.str().find("barnes_hut"), std::string::npos);
+
+    // An opening angle that is not a number names the field
+    std::istringstream badAngleInput{
+        "1\n"
+        "1.0e10 barnes-hut wide\n"
+        "0.0 0.0 0.0 0.0 1.0e24 earth.gif\n"
+    };
+    NB::Universe badAngleUniverse;
+    try {
+        badAngleInput >> badAngleUniverse;
+        BOOST_FAIL("A bad opening angle is accepted.");
+    } catch (const std::invalid_argument& exception) {
+        BOOST_REQUIRE_NE(std::string{ exception.what() }.find("opening angle"), std::string::npos);
+    }
+}
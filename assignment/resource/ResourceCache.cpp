@@ -0,0 +1,153 @@
+// Copyright 2024 James Chen
+
+#include "ResourceCache.hpp"
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Returns the live resource of a filename in a map of weak pointers; null if the resource
+ * has never been loaded or all its users are gone.
+ */
+template <typename T>
+std::shared_ptr<const T> find_live(
+    const std::unordered_map<std::string, std::weak_ptr<const T>>& map,
+    const std::string& filename) {
+    const auto it = map.find(filename);
+    return it == map.end() ? nullptr : it->second.lock();
+}
+
+/**
+ * @brief Decodes an image file; the image is empty if the file cannot be read.
+ */
+std::shared_ptr<const sf::Image> decode_image(const std::string& filename) {
+    auto image = std::make_shared<sf::Image>();
+    image->loadFromFile(filename);
+
+    return image;
+}
+
+}  // namespace
+
+namespace RC {
+
+ResourceCache& ResourceCache::shared() {
+    static ResourceCache cache;
+    return cache;
+}
+
+void ResourceCache::prefetchImages(const std::vector<std::string>& filenames) {
+    for (const auto& filename : filenames) {
+        if (find_live(m_textures, filename) != nullptr || m_pendingImages.count(filename) > 0) {
+            continue;
+        }
+
+        ++m_loadCount;
+        m_pendingImages[filename] = std::async(std::launch::async, decode_image, filename);
+    }
+}
+
+void ResourceCache::prefetchSoundBuffers(const std::vector<std::string>& filenames) {
+    for (const auto& filename : filenames) {
+        if (find_live(m_soundBuffers, filename) != nullptr ||
+            m_pendingSounds.count(filename) > 0) {
+            continue;
+        }
+
+        // The samples are decoded in the background; the buffer is created on the main thread
+        ++m_loadCount;
+        m_pendingSounds[filename] = std::async(std::launch::async, decodeSound, filename);
+    }
+}
+
+std::shared_ptr<const sf::Image> ResourceCache::image(const std::string& filename) {
+    const auto it = m_pendingImages.find(filename);
+    if (it == m_pendingImages.end()) {
+        ++m_loadCount;
+        return decode_image(filename);
+    }
+
+    auto image = it->second.get();
+    m_pendingImages.erase(it);
+
+    return image;
+}
+
+std::shared_ptr<const sf::Texture> ResourceCache::texture(const std::string& filename) {
+    if (auto texture = find_live(m_textures, filename)) {
+        return texture;
+    }
+
+    // Upload the image on this thread, which owns the OpenGL context
+    auto texture = std::make_shared<sf::Texture>();
+    texture->loadFromImage(*image(filename));
+    m_textures[filename] = texture;
+
+    return texture;
+}
+
+std::shared_ptr<const sf::Font> ResourceCache::font(const std::string& filename) {
+    if (auto font = find_live(m_fonts, filename)) {
+        return font;
+    }
+
+    // A font reads its glyphs on demand, so there is nothing to decode in the background
+    ++m_loadCount;
+    auto font = std::make_shared<sf::Font>();
+    font->loadFromFile(filename);
+    m_fonts[filename] = font;
+
+    return font;
+}
+
+std::shared_ptr<const sf::SoundBuffer> ResourceCache::soundBuffer(const std::string& filename) {
+    if (auto soundBuffer = find_live(m_soundBuffers, filename)) {
+        return soundBuffer;
+    }
+
+    auto soundBuffer = std::make_shared<sf::SoundBuffer>();
+    const auto sound = decodedSound(filename);
+    if (!sound->samples.empty()) {
+        soundBuffer->loadFromSamples(sound->samples.data(), sound->samples.size(),
+                                     sound->channelCount, sound->sampleRate);
+    }
+    m_soundBuffers[filename] = soundBuffer;
+
+    return soundBuffer;
+}
+
+std::size_t ResourceCache::loadCount() const { return m_loadCount; }
+
+std::shared_ptr<const ResourceCache::DecodedSound> ResourceCache::decodedSound(
+    const std::string& filename) {
+    const auto it = m_pendingSounds.find(filename);
+    if (it == m_pendingSounds.end()) {
+        ++m_loadCount;
+        return decodeSound(filename);
+    }
+
+    auto sound = it->second.get();
+    m_pendingSounds.erase(it);
+
+    return sound;
+}
+
+std::shared_ptr<const ResourceCache::DecodedSound> ResourceCache::decodeSound(
+    const std::string& filename) {
+    auto sound = std::make_shared<DecodedSound>();
+    sf::InputSoundFile file;
+    if (file.openFromFile(filename)) {
+        sound->samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+        const auto readCount = file.read(sound->samples.data(), sound->samples.size());
+        sound->samples.resize(static_cast<std::size_t>(readCount));
+        sound->channelCount = file.getChannelCount();
+        sound->sampleRate = file.getSampleRate();
+    }
+
+    return sound;
+}
+
+}  // namespace RC
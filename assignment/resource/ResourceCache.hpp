@@ -0,0 +1,138 @@
+// Copyright 2024 James Chen
+
+#ifndef RESOURCECACHE_HPP
+#define RESOURCECACHE_HPP
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief Resource cache namespace: the assets shared by the games.
+ */
+namespace RC {
+
+/**
+ * @brief This class loads the textures, fonts and sound buffers of a game, keyed by their
+ * filenames. A file is loaded once no matter how many objects ask for it: the cache hands out
+ * shared pointers and keeps weak ones, so a resource lives as long as somebody uses it, and is
+ * loaded again if it is asked for after all its users are gone.
+ *
+ * Images and sounds can be prefetched: they are decoded on background threads, while the textures
+ * and sound buffers are created from them on the calling thread when they are asked for, since
+ * textures belong to the OpenGL context of the main thread. All the functions of this class must
+ * be called from the main thread.
+ */
+class ResourceCache {
+ public:
+    /**
+     * @brief Returns the cache shared by the whole program.
+     */
+    [[nodiscard]] static ResourceCache& shared();
+
+    /**
+     * @brief Starts decoding images on background threads. A file that is cached, or is already
+     * being decoded, is skipped.
+     * @param filenames The filenames of the images.
+     */
+    void prefetchImages(const std::vector<std::string>& filenames);
+
+    /**
+     * @brief Starts decoding sounds on background threads. A file that is cached, or is already
+     * being decoded, is skipped.
+     * @param filenames The filenames of the sounds.
+     */
+    void prefetchSoundBuffers(const std::vector<std::string>& filenames);
+
+    /**
+     * @brief Returns a decoded image; waits for it if it is being decoded, and decodes it right
+     * away if it has not been prefetched. The image is not cached after it is returned.
+     * @param filename The filename of the image.
+     */
+    [[nodiscard]] std::shared_ptr<const sf::Image> image(const std::string& filename);
+
+    /**
+     * @brief Returns the texture of an image, which is created on the first request.
+     * @param filename The filename of the image.
+     */
+    [[nodiscard]] std::shared_ptr<const sf::Texture> texture(const std::string& filename);
+
+    /**
+     * @brief Returns a font, which is loaded on the first request.
+     * @param filename The filename of the font.
+     */
+    [[nodiscard]] std::shared_ptr<const sf::Font> font(const std::string& filename);
+
+    /**
+     * @brief Returns a sound buffer, which is created on the first request.
+     * @param filename The filename of the sound.
+     */
+    [[nodiscard]] std::shared_ptr<const sf::SoundBuffer> soundBuffer(const std::string& filename);
+
+    /**
+     * @brief Returns the number of files read since the cache was created.
+     */
+    [[nodiscard]] std::size_t loadCount() const;
+
+ private:
+    /**
+     * @brief The samples of a decoded sound.
+     */
+    struct DecodedSound {
+        std::vector<sf::Int16> samples;
+        unsigned channelCount = 0;
+        unsigned sampleRate = 0;
+    };
+
+    /**
+     * @brief Returns the decoded samples of a sound; waits for them if the sound is being decoded,
+     * and decodes it right away if it has not been prefetched.
+     */
+    [[nodiscard]] std::shared_ptr<const DecodedSound> decodedSound(const std::string& filename);
+
+    /**
+     * @brief Decodes the samples of a sound file; no samples if the file cannot be read. It runs
+     * on any thread.
+     */
+    [[nodiscard]] static std::shared_ptr<const DecodedSound> decodeSound(
+        const std::string& filename);
+
+    /**
+     * @brief The textures in use.
+     */
+    std::unordered_map<std::string, std::weak_ptr<const sf::Texture>> m_textures;
+
+    /**
+     * @brief The fonts in use.
+     */
+    std::unordered_map<std::string, std::weak_ptr<const sf::Font>> m_fonts;
+
+    /**
+     * @brief The sound buffers in use.
+     */
+    std::unordered_map<std::string, std::weak_ptr<const sf::SoundBuffer>> m_soundBuffers;
+
+    /**
+     * @brief The images being decoded, or decoded but not asked for yet.
+     */
+    std::unordered_map<std::string, std::future<std::shared_ptr<const sf::Image>>> m_pendingImages;
+
+    /**
+     * @brief The sounds being decoded, or decoded but not asked for yet.
+     */
+    std::unordered_map<std::string, std::future<std::shared_ptr<const DecodedSound>>>
+        m_pendingSounds;
+
+    /**
+     * @brief The number of files read.
+     */
+    std::size_t m_loadCount = 0;
+};
+
+}  // namespace RC
+
+#endif
@@ -2,98 +2,57 @@
 
 
 SB::Sokoban::Sokoban() {
-    auto wallTexture = sf::Texture{};
-    auto boxTexture = sf::Texture{};
-    auto groundTexture = sf::Texture{};
-    auto groundStorageTexture = sf::Texture{};
-    wallTexture.loadFromFile(TILESET_DIR + "block_06.png");
-    boxTexture.loadFromFile(TILESET_DIR + "crate_03.png");
-    groundTexture.loadFromFile(TILESET_DIR + "ground_01.png");
-    groundStorageTexture.loadFromFile(TILESET_DIR + "ground_04.png");
-
-    tile_textures_[TileChar::Player] = groundTexture;
-    tile_textures_[TileChar::EmptySpace] = groundTexture;
-    tile_textures_[TileChar::Wall] = wallTexture;
-    tile_textures_[TileChar::Box] = boxTexture;
-    tile_textures_[TileChar::Storage] = groundStorageTexture;
-    tile_textures_[TileChar::BoxStorage] = boxTexture;
-
-    auto playerUpTexture = sf::Texture{};
-    auto playerDownTexture = sf::Texture{};
-    auto playerLeftTexture = sf::Texture{};
-    auto playerRightTexture = sf::Texture{};
-    playerUpTexture.loadFromFile(TILESET_DIR + "player_08.png");
-    playerDownTexture.loadFromFile(TILESET_DIR + "player_05.png");
-    playerLeftTexture.loadFromFile(TILESET_DIR + "player_20.png");
-    playerRightTexture.loadFromFile(TILESET_DIR + "player_17.png");
-
-    player_textures_[Direction::Up] = playerUpTexture;
-    player_textures_[Direction::Down] = playerDownTexture;
-    player_textures_[Direction::Left] = playerLeftTexture;
-    player_textures_[Direction::Right] = playerRightTexture;
-
-    text_font_.loadFromFile(FONT_DIR + "roboto-regular.ttf");
-}
-
-void SB::Sokoban::movePlayer(const Direction dir) {
-    if (isWon()) {
-        return;
+    // Pack the tileset into one atlas, one slot for each image from left to right
+    const std::vector<std::string> filenames{ "ground_01.png", "ground_04.png", "block_06.png",
+                                              "crate_03.png",  "player_08.png", "player_05.png",
+                                              "player_20.png", "player_17.png" };
+    auto atlasImage = sf::Image{};
+    atlasImage.create(
+        static_cast<unsigned>(filenames.size()) * TILE_SIZE, TILE_SIZE, sf::Color::Transparent);
+    auto slots = std::vector<sf::IntRect>{};
+    for (unsigned i = 0; i < filenames.size(); i++) {
+        auto image = sf::Image{};
+        image.loadFromFile(REMAKE_TILESET_DIR + filenames[i]);
+        atlasImage.copy(image, i * TILE_SIZE, 0);
+        slots.emplace_back(
+            static_cast<int>(i * TILE_SIZE), 0, static_cast<int>(TILE_SIZE),
+            static_cast<int>(TILE_SIZE));
     }
-
-    // Change player's orientation
-    player_dir_ = dir;
-
-    // auto& currTileChar = tileAt(player_loc_);
-    switch (const auto nextCoord = Sokoban::nextCoord(player_loc_, dir); tileAt(nextCoord)) {
-        case TileChar::EmptySpace:
-            player_loc_ = nextCoord;
-            break;
-        case TileChar::BoxStorage:
-        case TileChar::Box: {
-            const auto [movable, boxNextCoord] = testBoxNextCoord(nextCoord, dir);
-            if (!movable) {
-                break;
-            }
-            player_loc_ = nextCoord;
-            moveBox(nextCoord, boxNextCoord);
-            break;
-        }
-        default:
-            break;
-    }
-}
-
-bool SB::Sokoban::isWon() const {
-    return num_boxes_storage == num_boxes || num_boxes_storage == num_storages;
-}
-
-void SB::Sokoban::reset() {
-    num_boxes_storage = initial_num_boxes_storage;
-    player_loc_ = initial_player_loc_;
-    player_dir_ = Direction::Down;
-    map_ = initial_map_;
+    atlas_.loadFromImage(atlasImage);
+
+    tile_rects_[TileChar::Player] = slots[0];
+    tile_rects_[TileChar::Empty] = slots[0];
+    tile_rects_[TileChar::Storage] = slots[1];
+    tile_rects_[TileChar::Wall] = slots[2];
+    tile_rects_[TileChar::Box] = slots[3];
+    tile_rects_[TileChar::BoxStorage] = slots[3];
+    tile_rects_[TileChar::PlayerStorage] = slots[1];
+
+    player_rects_[Direction::Up] = slots[4];
+    player_rects_[Direction::Down] = slots[5];
+    player_rects_[Direction::Left] = slots[6];
+    player_rects_[Direction::Right] = slots[7];
+
+    text_font_.loadFromFile(REMAKE_FONT_DIR + "roboto-regular.ttf");
 }
 
 void SB::Sokoban::draw(sf::RenderTarget& target, const sf::RenderStates states) const {
-    // Draw the map
-    for (unsigned row = 0; row < size_.y; row++) {
-        for (unsigned col = 0; col < size_.x; col++) {
-            auto tile_char = map_.at(col).at(row);
-            auto texture = tile_textures_.at(tile_char);
-            auto sprite = sf::Sprite(texture);
-            sprite.setPosition(
-                static_cast<float>(col * TILE_SIZE), static_cast<float>(row * TILE_SIZE));
-            target.draw(sprite, states);
-        }
-    }
-
-    // Draw the player
-    const auto texture = player_textures_.at(player_dir_);
-    auto sprite = sf::Sprite(texture);
-    sprite.setPosition(
-        static_cast<float>(player_loc_.x * TILE_SIZE),
-        static_cast<float>(player_loc_.y * TILE_SIZE));
-    target.draw(sprite, states);
+    // Batch the map and the player into one vertex array; the player is the last quad
+    const auto width = static_cast<unsigned>(this->width());
+    const auto height = static_cast<unsigned>(this->height());
+    vertices_.resize((width * height + 1) * 4);
+    traverseTileCharGrid([&](const sf::Vector2i coord, const TileChar tile_char) {
+        const sf::Vector2u tile_coord{ static_cast<unsigned>(coord.x),
+                                       static_cast<unsigned>(coord.y) };
+        setQuad(&vertices_[(tile_coord.y * width + tile_coord.x) * 4], tile_coord,
+                tile_rects_.at(tile_char));
+        return false;
+    });
+    setQuad(&vertices_[width * height * 4], playerLoc(), player_rects_.at(playerOrientation()));
+
+    auto atlasStates = states;
+    atlasStates.texture = &atlas_;
+    target.draw(vertices_, atlasStates);
 
     // If the player wins, display the "YOU WIN!" text in the middle of the window
     if (isWon()) {
@@ -112,100 +71,15 @@ void SB::Sokoban::draw(sf::RenderTarget& target, const sf::RenderStates states)
     }
 }
 
-sf::Vector2u SB::Sokoban::nextCoord(const sf::Vector2u& coord, const Direction dir) {
-    switch (dir) {
-        case Direction::Up:
-            return { coord.x, coord.y - 1 };
-        case Direction::Down:
-            return { coord.x, coord.y + 1 };
-        case Direction::Left:
-            return { coord.x - 1, coord.y };
-        case Direction::Right:
-            return { coord.x + 1, coord.y };
-        default:
-            return coord;
-    }
-}
-
-std::pair<bool, sf::Vector2u>
-SB::Sokoban::testBoxNextCoord(const sf::Vector2u& boxCoord, const Direction dir) const {
-    const auto nextCoord = Sokoban::nextCoord(boxCoord, dir);
-    if (nextCoord.x >= size_.x || nextCoord.y >= size_.y) {
-        return { false, boxCoord };
-    }
-    if (tileAtConst(nextCoord) == TileChar::Box || tileAtConst(nextCoord) == TileChar::Wall) {
-        return { false, boxCoord };
-    }
-
-    return { true, nextCoord };
-}
-
-void SB::Sokoban::moveBox(const sf::Vector2u& boxCoord, const sf::Vector2u& boxNextCoord) {
-    auto& boxTileChar = tileAt(boxCoord);
-    auto& boxNextTileChar = tileAt(boxNextCoord);
-    if (boxTileChar == TileChar::Box) {
-        boxTileChar = TileChar::EmptySpace;
-    } else if (boxTileChar == TileChar::BoxStorage) {
-        boxTileChar = TileChar::Storage;
-        num_boxes_storage--;
-    }
-
-    if (boxNextTileChar == TileChar::EmptySpace) {
-        boxNextTileChar = TileChar::Box;
-    } else if (boxNextTileChar == TileChar::Storage) {
-        boxNextTileChar = TileChar::BoxStorage;
-        num_boxes_storage++;
-    }
-}
-
-std::ostream& SB::operator<<(std::ostream& os, const Sokoban& sokoban) {
-    os << sokoban.size_.y << " " << sokoban.size_.x << std::endl;
-    for (unsigned row = 0; row < sokoban.size_.y; row++) {
-        for (unsigned col = 0; col < sokoban.size_.x; col++) {
-            os << static_cast<char>(sokoban.map_[col][row]);
-        }
-        os << std::endl;
-    }
-
-    return os;
-}
-
-std::istream& SB::operator>>(std::istream& is, Sokoban& sokoban) {
-    is >> sokoban.size_.y >> sokoban.size_.x;
-
-    for (unsigned col = 0; col < sokoban.size_.x; col++) {
-        sokoban.initial_map_.emplace_back(sokoban.size_.y);
-    }
-
-    for (unsigned row = 0; row < sokoban.size_.y; row++) {
-        for (unsigned col = 0; col < sokoban.size_.x; col++) {
-            char c;
-            is >> c;
-            const auto tileChar = static_cast<TileChar>(c);
-            sokoban.initial_map_[col][row] = tileChar;
-
-            if (tileChar == TileChar::Player) {
-                sokoban.initial_player_loc_ = { col, row };
-                sokoban.initial_map_[col][row] = TileChar::EmptySpace;
-            }
-
-            if (tileChar == TileChar::Box) {
-                sokoban.num_boxes++;
-            }
-
-            if (tileChar == TileChar::Storage) {
-                sokoban.num_storages++;
-            }
-
-            if (tileChar == TileChar::BoxStorage) {
-                sokoban.num_boxes++;
-                sokoban.num_storages++;
-                sokoban.initial_num_boxes_storage++;
-            }
-        }
-    }
-
-    sokoban.reset();
-
-    return is;
+void SB::Sokoban::setQuad(sf::Vertex* quad, const sf::Vector2u& coord, const sf::IntRect& rect) {
+    const auto x = static_cast<float>(coord.x * TILE_SIZE);
+    const auto y = static_cast<float>(coord.y * TILE_SIZE);
+    const auto size = static_cast<float>(TILE_SIZE);
+    const auto left = static_cast<float>(rect.left);
+    const auto top = static_cast<float>(rect.top);
+
+    quad[0] = sf::Vertex({ x, y }, { left, top });
+    quad[1] = sf::Vertex({ x + size, y }, { left + size, top });
+    quad[2] = sf::Vertex({ x + size, y + size }, { left + size, top + size });
+    quad[3] = sf::Vertex({ x, y + size }, { left, top + size });
 }
@@ -13,7 +13,7 @@ int main(int argc, char* argv[]) {
     auto inputStream = std::ifstream(argv[1]);
     inputStream >> sokoban;
 
-    // Output the map
+    // Output the map through the level file writer of the engine
     std::cout << sokoban << std::endl;
 
     auto windowVideoMode =